@@ -0,0 +1,89 @@
+// Compares the ways EntityManager can get its entity configs at startup.
+//
+//   survive_config_bench [iterations]
+//
+// static: copying the compiled-in definitions (their static initialisers already ran before main)
+// text:   parsing assets/entities.cfg
+// blob:   mapping, validating and decoding the compiled blob of the same text
+// map:    mapping and validating the blob only, what is left once decoding is skipped
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "Config/ConfigBlob.h"
+#include "Config/EntityConfigLoader.h"
+#include "MappedFile.h"
+#include "ResourceManager.h"
+
+namespace {
+    void report(const char *name, int iterations, const std::function<void()> &run)
+    {
+        std::vector<double> samples;
+        samples.reserve(iterations);
+        for (int i = 0; i < iterations; i++) {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            std::chrono::duration<double, std::micro> elapsed =
+                std::chrono::steady_clock::now() - start;
+            samples.push_back(elapsed.count());
+        }
+        std::sort(samples.begin(), samples.end());
+        std::cout << name << ": median " << samples[samples.size() / 2] << " us, min "
+                  << samples.front() << " us" << std::endl;
+    }
+
+    size_t countTypes(const EntityConfigTable &configs)
+    {
+        return std::count_if(configs.begin(), configs.end(),
+                             [](const auto &config) { return config.has_value(); });
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    ResourceManager::init(argv[0]);
+    const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1000;
+
+    const std::string textPath = ResourceManager::getFilePath("entities.cfg");
+    const std::string blobPath = ResourceManager::getFilePath("entities.bench.bin");
+
+    EntityConfigTable configs = Config::copyEntityConfigs();
+    MappedFile text;
+    if (!text.open(textPath) || !EntityConfigLoader::loadFromFile(textPath, configs)) {
+        std::cerr << "Unable to read " << textPath << std::endl;
+        return 1;
+    }
+    if (!ConfigBlob::write(blobPath, configs, ConfigBlob::hash(text.data(), text.size()))) {
+        return 1;
+    }
+    std::cout << countTypes(configs) << " entity types, " << iterations << " iterations"
+              << std::endl;
+
+    size_t sink = 0;
+    report("static", iterations, [&] { sink += countTypes(Config::copyEntityConfigs()); });
+    report("text", iterations, [&] {
+        EntityConfigTable loaded = Config::copyEntityConfigs();
+        EntityConfigLoader::loadFromFile(textPath, loaded);
+        sink += countTypes(loaded);
+    });
+    report("blob", iterations, [&] {
+        EntityConfigTable loaded = Config::copyEntityConfigs();
+        ConfigBlob blob;
+        if (blob.open(blobPath))
+            blob.decode(loaded);
+        sink += countTypes(loaded);
+    });
+    report("map", iterations, [&] {
+        ConfigBlob blob;
+        if (blob.open(blobPath))
+            sink += blob.getEntityCount();
+    });
+
+    std::remove(blobPath.c_str());
+    return sink == 0;
+}
@@ -0,0 +1,98 @@
+// Scaling of JobSystem::parallelFor from one thread to all hardware threads on a synthetic
+// per-entity workload: a few steps of steering and integration per entity.
+//
+//   survive_job_bench [entities] [grain] [iterations]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "JobSystem.h"
+
+namespace {
+    struct Entities
+    {
+        std::vector<float> x, y, vx, vy;
+
+        explicit Entities(size_t count)
+            : x(count)
+            , y(count)
+            , vx(count)
+            , vy(count)
+        {
+            for (size_t i = 0; i < count; i++) {
+                x[i] = static_cast<float>(i % 1600);
+                y[i] = static_cast<float>(i / 1600 % 1200);
+            }
+        }
+    };
+
+    // Steer towards a point and integrate, repeated so each entity costs about as much as a
+    // real system update would
+    void update(Entities &e, size_t first, size_t last)
+    {
+        const float dt = 1.f / 144.f;
+        for (size_t i = first; i < last; i++) {
+            for (int step = 0; step < 16; step++) {
+                const float dx = 800.f - e.x[i];
+                const float dy = 600.f - e.y[i];
+                const float length = std::sqrt(dx * dx + dy * dy) + 1.f;
+                const float angle = std::atan2(dy, dx);
+                e.vx[i] += (std::cos(angle) * 100.f - e.vx[i] * 0.1f) * dt + dx / length;
+                e.vy[i] += (std::sin(angle) * 100.f - e.vy[i] * 0.1f) * dt + dy / length;
+                e.x[i] += e.vx[i] * dt;
+                e.y[i] += e.vy[i] * dt;
+            }
+        }
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const size_t grain = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+    const int iterations = argc > 3 ? std::max(1, std::atoi(argv[3])) : 50;
+    const size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << count << " entities, grain " << grain << ", " << iterations << " iterations"
+              << std::endl;
+
+    // Powers of two up to the hardware thread count, and the count itself
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double baseline = 0.0;
+    for (size_t threads : threadCounts) {
+        JobSystem jobs(threads);
+        Entities entities(count);
+
+        std::vector<double> samples;
+        samples.reserve(iterations);
+        for (int i = 0; i < iterations; i++) {
+            auto start = std::chrono::steady_clock::now();
+            jobs.parallelFor(0, count, grain,
+                             [&entities](size_t first, size_t last) {
+                                 update(entities, first, last);
+                             });
+            std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start;
+            samples.push_back(elapsed.count());
+        }
+        std::sort(samples.begin(), samples.end());
+        const double median = samples[samples.size() / 2];
+        if (threads == 1) {
+            baseline = median;
+        }
+
+        std::cout << threads << " threads: median " << median << " ms, speedup "
+                  << baseline / median << "x" << std::endl;
+    }
+    return 0;
+}
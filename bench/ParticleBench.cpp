@@ -0,0 +1,89 @@
+// Steady state cost of the particle system at a given number of live particles: every frame
+// tops the pool back up with explosion bursts, steps it at 144 Hz and streams it into a vertex
+// array, the CPU side of what Game and RenderSystem do with it. Drawing is not part of it.
+//
+//   survive_particle_bench [particles] [frames]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "Constants.h"
+#include "ParticleSystem.h"
+#include "Random.h"
+
+namespace {
+    struct Samples
+    {
+        const char *name;
+        std::vector<double> ms;
+    };
+
+    void report(Samples &samples)
+    {
+        std::sort(samples.ms.begin(), samples.ms.end());
+        const size_t size = samples.ms.size();
+        std::cout << samples.name << ": median " << samples.ms[size / 2] << " ms, p99 "
+                  << samples.ms[std::min(size - 1, size * 99 / 100)] << " ms, max "
+                  << samples.ms.back() << " ms" << std::endl;
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const size_t particles = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const int frames = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1000;
+    const float deltaTime = 1.f / 144.f;
+
+    ParticleSystem system(std::max<size_t>(particles, Constants::PARTICLE_CAPACITY));
+    sf::VertexArray vertices(sf::Triangles);
+    Random random(1);
+
+    // Explosions all over the screen until the pool holds the requested count
+    auto topUp = [&]() {
+        while (system.getCount() < particles) {
+            ParticleBurst burst = Config::EXPLOSION;
+            burst.count = std::min(burst.count, particles - system.getCount());
+            const sf::Vector2f position(random.range(0.f, Constants::SCREEN_WIDTH),
+                                        random.range(0.f, Constants::SCREEN_HEIGHT));
+            system.emit(position, {1.f, 0.f}, burst);
+        }
+    };
+
+    // A second of warmup, so lifetimes are spread out and the vertex array has grown
+    for (int i = 0; i < 144; i++) {
+        topUp();
+        system.update(deltaTime);
+        system.writeVertices(vertices);
+    }
+
+    Samples emit{"emit"}, update{"update"}, stream{"vertices"}, frame{"frame"};
+    size_t emittedTotal = 0;
+    for (int i = 0; i < frames; i++) {
+        const size_t before = system.getCount();
+        auto start = std::chrono::steady_clock::now();
+        topUp();
+        auto emitted = std::chrono::steady_clock::now();
+        emittedTotal += system.getCount() - before;
+        system.update(deltaTime);
+        auto updated = std::chrono::steady_clock::now();
+        system.writeVertices(vertices);
+        auto streamed = std::chrono::steady_clock::now();
+
+        emit.ms.push_back(std::chrono::duration<double, std::milli>(emitted - start).count());
+        update.ms.push_back(std::chrono::duration<double, std::milli>(updated - emitted).count());
+        stream.ms.push_back(std::chrono::duration<double, std::milli>(streamed - updated).count());
+        frame.ms.push_back(std::chrono::duration<double, std::milli>(streamed - start).count());
+    }
+
+    std::cout << particles << " particles, " << frames << " frames at 144 Hz, "
+              << emittedTotal / frames << " emitted per frame, frame budget " << 1000.f / 144.f
+              << " ms" << std::endl;
+    report(emit);
+    report(update);
+    report(stream);
+    report(frame);
+    return 0;
+}
@@ -0,0 +1,450 @@
+// Runs named scenarios on a headless Game for a fixed number of ticks with a fixed seed and
+// writes per-system timings and entity counts, as CSV or JSON, so runs can be diffed across
+// commits.
+//
+//   survive_bench [--scenario NAME|all] [--count N] [--ticks N] [--warmup N] [--seed N]
+//                 [--format csv|json] [--out PATH] [--no-alloc-after TICKS] [--overlay]
+//
+// Scenarios:
+//   boxes   N TEST_BOX circles bouncing around the arena
+//   horde   N vampires spread over the arena, the player walks through them firing
+//   laser   the player fires N lasers over the run while walking
+//   pileup  N TEST_BOXes thrown at the right wall
+//
+// Timings are taken after the warmup ticks: mean, p50, p99 and max per scheduled system plus
+// the whole update. Everything the game prints goes to stderr, stdout only gets the results.
+//
+// --no-alloc-after fails the run, after writing the results, when any scheduled system
+// allocates once that many ticks of a scenario have passed. It needs a build with
+// SURVIVE_TRACK_ALLOCATIONS.
+//
+// --overlay feeds a visible PerformanceOverlay after every tick, as a game with a window does, and
+// adds the time its update takes as the "overlay" row. Drawing it is not timed, there is no window.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AllocTracker.h"
+#include "Game.h"
+#include "Entity.h"
+#include "Config/EntityConfigLoader.h"
+#include "InputSource.h"
+#include "JobSystem.h"
+#include "ResourceManager.h"
+#include "MathUtils.h"
+#include "PerformanceOverlay.h"
+#include "Random.h"
+
+namespace {
+    struct Options
+    {
+        int count{-1}; // -1: the scenario's default
+        uint64_t ticks{1200};
+        uint64_t warmup{120};
+        uint32_t seed{1};
+        int64_t noAllocAfter{-1}; // -1: allocations are not checked
+        bool overlay{false};
+    };
+
+    struct Scenario
+    {
+        const char *name;
+        int defaultCount;
+        // Spawns the scenario's entities and scripts the player
+        void (*setup)(Game &game, Random &random, int count, uint64_t ticks,
+                      ScriptedInputSource &script);
+    };
+
+    struct Timing
+    {
+        std::string name;
+        double mean{0.0};
+        double p50{0.0};
+        double p99{0.0};
+        double max{0.0};
+    };
+
+    struct Result
+    {
+        const Scenario *scenario;
+        int count;
+        std::vector<Timing> timings;
+        std::array<size_t, ENTITY_TYPE_COUNT> entities{};
+        size_t entityCount{0};
+        uint64_t allocatingTicks{0}; // past --no-alloc-after
+    };
+
+    // Walks a square, sweeps the mouse around the player and fires every fireEvery ticks
+    void patrol(ScriptedInputSource &script, uint64_t ticks, uint64_t fireEvery)
+    {
+        const sf::Keyboard::Key walk[] = {sf::Keyboard::D, sf::Keyboard::S, sf::Keyboard::A,
+                                          sf::Keyboard::W};
+        const uint64_t legTicks = 144;
+        for (uint64_t tick = 0, leg = 0; tick < ticks; tick += legTicks, leg++) {
+            script.press(tick, walk[leg % 4]);
+            script.release(tick + legTicks - 1, walk[leg % 4]);
+        }
+
+        const sf::Vector2f center(Constants::SCREEN_WIDTH / 2.f, Constants::SCREEN_HEIGHT / 2.f);
+        for (uint64_t tick = 0; tick < ticks; tick += 10) {
+            float angle = 2.f * PI * static_cast<float>(tick % 720) / 720.f;
+            script.moveMouse(tick, center + sf::Vector2f(std::cos(angle), std::sin(angle)) * 400.f);
+        }
+
+        // A press only fires once it was released, so presses need at least two ticks
+        fireEvery = std::max<uint64_t>(fireEvery, 2);
+        for (uint64_t tick = 1; tick < ticks; tick += fireEvery) {
+            script.press(tick, sf::Keyboard::Space);
+            script.release(tick + 1, sf::Keyboard::Space);
+        }
+    }
+
+    const sf::FloatRect ARENA(50.f, 50.f, Constants::SCREEN_WIDTH - 100.f,
+                              Constants::SCREEN_HEIGHT - 100.f);
+
+    void setupBoxes(Game &game, Random &random, int count, uint64_t,
+                    ScriptedInputSource &)
+    {
+        std::vector<sf::Vector2f> positions(count), velocities(count);
+        random.fill(positions.data(), positions.size(), ARENA);
+        random.fill(velocities.data(), velocities.size(),
+                    sf::FloatRect(-100.f, -100.f, 200.f, 200.f));
+        game.spawnWave(EntityType::TEST_BOX, positions, velocities,
+                       std::vector<float>(count, 10.f));
+    }
+
+    void setupHorde(Game &game, Random &random, int count, uint64_t ticks,
+                    ScriptedInputSource &script)
+    {
+        std::vector<sf::Vector2f> positions(count);
+        random.fill(positions.data(), positions.size(), ARENA);
+        game.spawnWave(EntityType::VAMPIRE, positions, {},
+                       std::vector<float>(count, Constants::VAMPIRE_HEALTH));
+        patrol(script, ticks, 144);
+    }
+
+    void setupLaser(Game &, Random &, int count, uint64_t ticks,
+                    ScriptedInputSource &script)
+    {
+        patrol(script, ticks, count > 0 ? ticks / count : ticks);
+    }
+
+    void setupPileup(Game &game, Random &random, int count, uint64_t,
+                     ScriptedInputSource &)
+    {
+        // Everything starts in the left half and heads right at speed
+        const sf::FloatRect left(ARENA.left, ARENA.top, ARENA.width / 2.f, ARENA.height);
+        std::vector<sf::Vector2f> positions(count), velocities(count);
+        random.fill(positions.data(), positions.size(), left);
+        random.fill(velocities.data(), velocities.size(),
+                    sf::FloatRect(300.f, -30.f, 200.f, 60.f));
+        game.spawnWave(EntityType::TEST_BOX, positions, velocities,
+                       std::vector<float>(count, 10.f));
+    }
+
+    const Scenario SCENARIOS[] = {
+        {"boxes", 500, setupBoxes},
+        {"horde", 1000, setupHorde},
+        {"laser", 200, setupLaser},
+        {"pileup", 400, setupPileup},
+    };
+
+    // Nearest rank, samples sorted
+    double percentile(const std::vector<double> &samples, double fraction)
+    {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        size_t rank = static_cast<size_t>(std::ceil(fraction * samples.size()));
+        return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+    }
+
+    Timing summarise(std::string name, std::vector<double> &samples)
+    {
+        Timing timing;
+        timing.name = std::move(name);
+        if (samples.empty()) {
+            return timing;
+        }
+        std::sort(samples.begin(), samples.end());
+        double total = 0.0;
+        for (double sample : samples) {
+            total += sample;
+        }
+        timing.mean = total / samples.size();
+        timing.p50 = percentile(samples, 0.5);
+        timing.p99 = percentile(samples, 0.99);
+        timing.max = samples.back();
+        return timing;
+    }
+
+    // Counts the ticks on which a scheduled system allocated and names the systems of the first
+    void checkAllocations(const SystemScheduler &scheduler, const Scenario &scenario,
+                          uint64_t tick, Result &result)
+    {
+        bool allocated = false;
+        for (size_t i = 0; i < scheduler.getSystemCount(); i++) {
+            allocated |= scheduler.getLastAllocations(i).count > 0;
+        }
+        if (!allocated || result.allocatingTicks++ > 0) {
+            return;
+        }
+        std::cerr << scenario.name << " tick " << tick << " allocated in:";
+        for (size_t i = 0; i < scheduler.getSystemCount(); i++) {
+            const AllocCounts &allocations = scheduler.getLastAllocations(i);
+            if (allocations.count > 0) {
+                std::cerr << " " << scheduler.getSystemName(i) << " (" << allocations.count
+                          << " allocations, " << allocations.bytes << " bytes)";
+            }
+        }
+        std::cerr << std::endl;
+    }
+
+    bool runScenario(const Scenario &scenario, const Options &options, Result &result)
+    {
+        result.scenario = &scenario;
+        result.count = options.count >= 0 ? options.count : scenario.defaultCount;
+
+        Game game;
+        if (!game.initialise(true)) {
+            std::cerr << "Game failed to initialise" << std::endl;
+            return false;
+        }
+        game.setSeed(options.seed);
+
+        // Headless games load no font, the overlay needs one
+        sf::Font font;
+        std::unique_ptr<PerformanceOverlay> overlay;
+        if (options.overlay) {
+            if (!ResourceManager::loadFont("Lavigne.ttf", font)) {
+                std::cerr << "Unable to load font" << std::endl;
+                return false;
+            }
+            overlay = std::make_unique<PerformanceOverlay>(font);
+            overlay->toggle();
+        }
+
+        Random random = game.getRandom().getStream(RandomService::Bench);
+        ScriptedInputSource script;
+        scenario.setup(game, random, result.count, options.ticks, script);
+
+        SystemScheduler &scheduler = game.getScheduler();
+        const float deltaTime = 1.f / 144.f;
+        const uint64_t measured =
+            options.ticks > options.warmup ? options.ticks - options.warmup : 0;
+        std::vector<double> updateMs;
+        std::vector<double> overlayMs;
+        std::vector<std::vector<double>> systemMs(scheduler.getSystemCount());
+        updateMs.reserve(measured);
+        overlayMs.reserve(overlay ? measured : 0);
+        for (auto &samples : systemMs) {
+            samples.reserve(measured);
+        }
+
+        for (uint64_t tick = 0; tick < options.ticks; tick++) {
+            auto start = std::chrono::steady_clock::now();
+            game.update(deltaTime, script);
+            std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start;
+            std::chrono::duration<double, std::milli> overlayElapsed{0};
+            if (overlay) {
+                auto overlayStart = std::chrono::steady_clock::now();
+                overlay->update(game.getOverlayStats(deltaTime * 1000.f,
+                                                     static_cast<float>(elapsed.count())));
+                overlayElapsed = std::chrono::steady_clock::now() - overlayStart;
+            }
+            if (options.noAllocAfter >= 0 && tick >= static_cast<uint64_t>(options.noAllocAfter)) {
+                checkAllocations(scheduler, scenario, tick, result);
+            }
+            if (tick < options.warmup) {
+                continue;
+            }
+            updateMs.push_back(elapsed.count());
+            if (overlay) {
+                overlayMs.push_back(overlayElapsed.count());
+            }
+            for (size_t i = 0; i < scheduler.getSystemCount(); i++) {
+                systemMs[i].push_back(scheduler.getLastDurationMs(i));
+            }
+        }
+
+        result.timings.push_back(summarise("update", updateMs));
+        for (size_t i = 0; i < scheduler.getSystemCount(); i++) {
+            result.timings.push_back(summarise(scheduler.getSystemName(i), systemMs[i]));
+        }
+        if (overlay) {
+            result.timings.push_back(summarise("overlay", overlayMs));
+        }
+        for (const auto &entity : game.getEntities()) {
+            result.entities[toIndex(entity->getType())]++;
+        }
+        result.entityCount = game.getEntityCount();
+        return true;
+    }
+
+    void writeCsv(std::ostream &out, const std::vector<Result> &results, const Options &options)
+    {
+        out << "scenario,count,ticks,warmup,seed,system,mean_ms,p50_ms,p99_ms,max_ms,entities";
+        for (size_t type = 0; type < ENTITY_TYPE_COUNT; type++) {
+            out << "," << EntityConfigLoader::getTypeName(static_cast<EntityType>(type));
+        }
+        out << "\n";
+
+        for (const Result &result : results) {
+            for (const Timing &timing : result.timings) {
+                out << result.scenario->name << "," << result.count << "," << options.ticks << ","
+                    << options.warmup << "," << options.seed << "," << timing.name << ","
+                    << timing.mean << "," << timing.p50 << "," << timing.p99 << "," << timing.max
+                    << "," << result.entityCount;
+                for (size_t count : result.entities) {
+                    out << "," << count;
+                }
+                out << "\n";
+            }
+        }
+    }
+
+    void writeJson(std::ostream &out, const std::vector<Result> &results, const Options &options)
+    {
+        out << "{\n  \"ticks\": " << options.ticks << ",\n  \"warmup\": " << options.warmup
+            << ",\n  \"seed\": " << options.seed
+            << ",\n  \"threads\": " << JobSystem::getInstance().getThreadCount()
+            << ",\n  \"scenarios\": [";
+        for (size_t r = 0; r < results.size(); r++) {
+            const Result &result = results[r];
+            out << (r ? "," : "") << "\n    {\n      \"name\": \"" << result.scenario->name
+                << "\",\n      \"count\": " << result.count << ",\n      \"entities\": {\"total\": "
+                << result.entityCount;
+            for (size_t type = 0; type < ENTITY_TYPE_COUNT; type++) {
+                out << ", \"" << EntityConfigLoader::getTypeName(static_cast<EntityType>(type))
+                    << "\": " << result.entities[type];
+            }
+            out << "},\n      \"systems\": [";
+            for (size_t t = 0; t < result.timings.size(); t++) {
+                const Timing &timing = result.timings[t];
+                out << (t ? "," : "") << "\n        {\"name\": \"" << timing.name
+                    << "\", \"mean_ms\": " << timing.mean << ", \"p50_ms\": " << timing.p50
+                    << ", \"p99_ms\": " << timing.p99 << ", \"max_ms\": " << timing.max << "}";
+            }
+            out << "\n      ]\n    }";
+        }
+        out << "\n  ]\n}\n";
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    ResourceManager::init(argv[0]);
+
+    Options options;
+    std::string scenarioName = "all";
+    std::string format = "csv";
+    const char *outPath = nullptr;
+    for (int i = 1; i < argc; i += 2) {
+        // The flags without a value
+        if (std::strcmp(argv[i], "--overlay") == 0) {
+            options.overlay = true;
+            i--;
+            continue;
+        }
+        if (i + 1 == argc) {
+            std::cerr << "Missing value for " << argv[i] << std::endl;
+            return 1;
+        }
+        if (std::strcmp(argv[i], "--scenario") == 0)
+            scenarioName = argv[i + 1];
+        else if (std::strcmp(argv[i], "--count") == 0)
+            options.count = std::atoi(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--ticks") == 0)
+            options.ticks = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--warmup") == 0)
+            options.warmup = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--seed") == 0)
+            options.seed = static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        else if (std::strcmp(argv[i], "--format") == 0)
+            format = argv[i + 1];
+        else if (std::strcmp(argv[i], "--out") == 0)
+            outPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--no-alloc-after") == 0)
+            options.noAllocAfter = std::atoll(argv[i + 1]);
+        else {
+            std::cerr << "Unknown argument " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    if (format != "csv" && format != "json") {
+        std::cerr << "Unknown format " << format << ", expected csv or json" << std::endl;
+        return 1;
+    }
+
+    if (options.noAllocAfter >= 0 && !AllocTracker::isEnabled()) {
+        std::cerr << "--no-alloc-after needs a build with SURVIVE_TRACK_ALLOCATIONS on"
+                  << std::endl;
+        return 1;
+    }
+
+    std::vector<const Scenario *> selected;
+    for (const Scenario &scenario : SCENARIOS) {
+        if (scenarioName == "all" || scenarioName == scenario.name) {
+            selected.push_back(&scenario);
+        }
+    }
+    if (selected.empty()) {
+        std::cerr << "Unknown scenario " << scenarioName << std::endl;
+        return 1;
+    }
+
+    // The game reports spawns and asset loading on stdout, keep stdout for the results
+    std::streambuf *stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+
+    std::vector<Result> results;
+    for (const Scenario *scenario : selected) {
+        std::cerr << "Running " << scenario->name << std::endl;
+        Result result;
+        if (!runScenario(*scenario, options, result)) {
+            std::cout.rdbuf(stdoutBuffer);
+            return 1;
+        }
+        results.push_back(std::move(result));
+    }
+
+    std::cout.rdbuf(stdoutBuffer);
+
+    std::ofstream file;
+    if (outPath) {
+        file.open(outPath);
+        if (!file) {
+            std::cerr << "Unable to write " << outPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &out = outPath ? static_cast<std::ostream &>(file) : std::cout;
+    if (format == "json")
+        writeJson(out, results, options);
+    else
+        writeCsv(out, results, options);
+
+    if (!out) {
+        return 1;
+    }
+
+    bool allocated = false;
+    for (const Result &result : results) {
+        if (result.allocatingTicks > 0) {
+            std::cerr << "FAILED: " << result.scenario->name
+                      << " allocated in scheduled systems on " << result.allocatingTicks
+                      << " ticks after the first " << options.noAllocAfter << std::endl;
+            allocated = true;
+        }
+    }
+    return allocated ? 1 : 0;
+}
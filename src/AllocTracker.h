@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+struct AllocCounts
+{
+    uint64_t count{0};
+    uint64_t bytes{0};
+
+    AllocCounts operator-(const AllocCounts &start) const
+    {
+        return {count - start.count, bytes - start.bytes};
+    }
+    AllocCounts &operator+=(const AllocCounts &other)
+    {
+        count += other.count;
+        bytes += other.bytes;
+        return *this;
+    }
+};
+
+// Counts heap allocations. Builds with SURVIVE_TRACK_ALLOCATIONS replace the global operator
+// new and delete with versions that count every allocation into a process wide total and into
+// the innermost Scope open on the allocating thread, e.g. the system SystemScheduler is running.
+// Without it nothing is counted and the scopes are empty.
+class AllocTracker
+{
+public:
+    static constexpr bool isEnabled()
+    {
+#ifdef SURVIVE_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Every allocation so far, on all threads
+    static AllocCounts getTotal();
+
+    // Allocations on this thread go into counts while the scope is open, nested scopes
+    // take over until they close
+    class Scope
+    {
+    public:
+#ifdef SURVIVE_TRACK_ALLOCATIONS
+        explicit Scope(AllocCounts &counts);
+        ~Scope();
+#else
+        explicit Scope(AllocCounts &) {}
+#endif
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+#ifdef SURVIVE_TRACK_ALLOCATIONS
+    private:
+        AllocCounts *m_previous;
+#endif
+    };
+
+    // Called by the replaced operator new
+    static void onAllocate(size_t bytes);
+};
@@ -0,0 +1,46 @@
+#include "AssetManifest.h"
+
+#include <algorithm>
+
+AssetManifest AssetManifest::fromConfigs(const EntityConfigTable &configs)
+{
+    AssetManifest manifest;
+    for (const auto &config : configs) {
+        if (!config.has_value() || !config->visual.has_value() ||
+            config->visual->filename.empty()) {
+            continue;
+        }
+
+        sf::Vector2u extent{0, 0};
+        for (const auto &animation : config->animations) {
+            if (!animation.has_value()) {
+                continue;
+            }
+            const AnimationInfo &anim = *animation;
+            unsigned width = anim.startPos.x + anim.frameCount * anim.frameSize.x;
+            unsigned height = (anim.startPos.y + 1) * anim.frameSize.y;
+            extent.x = std::max(extent.x, width);
+            extent.y = std::max(extent.y, height);
+        }
+        manifest.addTexture(config->visual->filename, extent);
+    }
+    return manifest;
+}
+
+void AssetManifest::addTexture(const std::string &filename, const sf::Vector2u &extent)
+{
+    // Types sharing a sheet list it once, with the largest area any of them expects
+    for (AssetEntry &entry : m_entries) {
+        if (entry.kind == AssetEntry::Kind::Texture && entry.filename == filename) {
+            entry.extent.x = std::max(entry.extent.x, extent.x);
+            entry.extent.y = std::max(entry.extent.y, extent.y);
+            return;
+        }
+    }
+    m_entries.push_back({AssetEntry::Kind::Texture, filename, extent});
+}
+
+void AssetManifest::addFont(const std::string &filename)
+{
+    m_entries.push_back({AssetEntry::Kind::Font, filename, {0, 0}});
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <string>
+#include <vector>
+
+#include "Config/GameConfig.h"
+
+// One file to load at startup
+struct AssetEntry
+{
+    enum class Kind
+    {
+        Texture,
+        Font
+    };
+
+    Kind kind;
+    std::string filename;
+    // Textures only: the area the animations expect, the size of the blank stand-in when the
+    // file fails to load
+    sf::Vector2u extent{0, 0};
+};
+
+// Everything startup has to load, so it can all be decoded up front instead of on first use
+class AssetManifest
+{
+public:
+    // Every sprite sheet the entity configs reference, each listed once
+    static AssetManifest fromConfigs(const EntityConfigTable &configs);
+
+    void addTexture(const std::string &filename, const sf::Vector2u &extent);
+    void addFont(const std::string &filename);
+
+    const std::vector<AssetEntry> &getEntries() const { return m_entries; }
+    size_t size() const { return m_entries.size(); }
+
+private:
+    std::vector<AssetEntry> m_entries;
+};
@@ -0,0 +1,212 @@
+#include "AssetPack.h"
+
+#include <SFML/Graphics/Image.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+    constexpr uint64_t DATA_ALIGNMENT = 16;
+
+    uint64_t align(uint64_t size, uint64_t alignment)
+    {
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+
+    bool isImage(const std::filesystem::path &path)
+    {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension == ".png" || extension == ".jpg" || extension == ".jpeg" ||
+               extension == ".bmp" || extension == ".tga";
+    }
+
+    struct PendingEntry
+    {
+        std::string name;
+        AssetPack::Kind kind;
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint8_t> data;
+    };
+
+    bool readFile(const std::filesystem::path &path, std::vector<uint8_t> &out)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return false;
+        }
+        out.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        return static_cast<bool>(file.read(reinterpret_cast<char *>(out.data()), out.size()));
+    }
+} // namespace
+
+static_assert(sizeof(AssetPack::Header) % 8 == 0, "pack header must keep 8 byte alignment");
+static_assert(sizeof(AssetPack::Entry) % 8 == 0, "pack entries must keep 8 byte alignment");
+
+bool AssetPack::write(const std::string &directory, const std::string &path)
+{
+    namespace fs = std::filesystem;
+    std::error_code error;
+    const fs::path output = fs::absolute(path, error);
+
+    // Sorted, so the same directory always produces the same bytes
+    std::vector<fs::path> files;
+    for (const auto &item : fs::recursive_directory_iterator(directory, error)) {
+        if (item.is_regular_file() && fs::absolute(item.path(), error) != output) {
+            files.push_back(item.path());
+        }
+    }
+    if (error) {
+        std::cerr << "Unable to list " << directory << ": " << error.message() << std::endl;
+        return false;
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<PendingEntry> pending;
+    pending.reserve(files.size());
+    for (const fs::path &file : files) {
+        PendingEntry entry{fs::relative(file, directory).generic_string(), Kind::Raw, 0, 0, {}};
+
+        sf::Image image;
+        if (isImage(file) && image.loadFromFile(file.string())) {
+            entry.kind = Kind::Pixels;
+            entry.width = image.getSize().x;
+            entry.height = image.getSize().y;
+            const uint8_t *pixels = image.getPixelsPtr();
+            entry.data.assign(pixels, pixels + size_t(entry.width) * entry.height * 4);
+        }
+        else if (!readFile(file, entry.data)) {
+            std::cerr << "Unable to read " << file.string() << std::endl;
+            return false;
+        }
+        pending.push_back(std::move(entry));
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.endianCheck = ENDIAN_CHECK;
+    header.entryCount = static_cast<uint32_t>(pending.size());
+    header.entryOffset = static_cast<uint32_t>(align(sizeof(Header), 8));
+    header.nameOffset = header.entryOffset + static_cast<uint32_t>(pending.size() * sizeof(Entry));
+
+    std::string names;
+    std::vector<Entry> entries;
+    entries.reserve(pending.size());
+    for (const PendingEntry &item : pending) {
+        Entry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.nameOffset = static_cast<uint32_t>(names.size());
+        entry.nameSize = static_cast<uint32_t>(item.name.size());
+        entry.kind = item.kind;
+        entry.width = item.width;
+        entry.height = item.height;
+        entry.dataSize = item.data.size();
+        entries.push_back(entry);
+        names += item.name;
+    }
+    header.nameSize = static_cast<uint32_t>(names.size());
+
+    uint64_t offset = align(uint64_t(header.nameOffset) + names.size(), DATA_ALIGNMENT);
+    for (Entry &entry : entries) {
+        entry.dataOffset = offset;
+        offset = align(offset + entry.dataSize, DATA_ALIGNMENT);
+    }
+    header.totalSize = offset;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    auto pad = [&file](uint64_t to) {
+        static const char zeros[DATA_ALIGNMENT] = {};
+        const uint64_t at = static_cast<uint64_t>(file.tellp());
+        if (to > at)
+            file.write(zeros, static_cast<std::streamsize>(to - at));
+    };
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    pad(header.entryOffset);
+    file.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(Entry));
+    file.write(names.data(), names.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        pad(entries[i].dataOffset);
+        file.write(reinterpret_cast<const char *>(pending[i].data.data()), pending[i].data.size());
+    }
+    pad(header.totalSize);
+
+    if (!file) {
+        std::cerr << "Unable to write asset pack " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool AssetPack::open(const std::string &path)
+{
+    close();
+    if (!m_file.open(path)) {
+        return false;
+    }
+
+    auto reject = [this, &path](const char *reason) {
+        std::cerr << "Ignoring asset pack " << path << ": " << reason << std::endl;
+        close();
+        return false;
+    };
+
+    const uint64_t fileSize = m_file.size();
+    if (fileSize < sizeof(Header)) {
+        return reject("truncated");
+    }
+    const Header *header = reinterpret_cast<const Header *>(m_file.data());
+    if (header->magic != MAGIC) {
+        return reject("not an asset pack");
+    }
+    if (header->endianCheck != ENDIAN_CHECK) {
+        return reject("written on a machine with a different byte order");
+    }
+    if (header->version != VERSION) {
+        return reject("version mismatch, rebuild it");
+    }
+    if (header->totalSize != fileSize || header->entryOffset % 8 != 0 ||
+        uint64_t(header->entryOffset) + uint64_t(header->entryCount) * sizeof(Entry) > fileSize ||
+        uint64_t(header->nameOffset) + header->nameSize > fileSize) {
+        return reject("section out of bounds");
+    }
+
+    const Entry *entries = reinterpret_cast<const Entry *>(m_file.data() + header->entryOffset);
+    const char *names = reinterpret_cast<const char *>(m_file.data() + header->nameOffset);
+    for (uint32_t i = 0; i < header->entryCount; i++) {
+        const Entry &entry = entries[i];
+        const uint64_t pixelBytes = uint64_t(entry.width) * entry.height * 4;
+        if (uint64_t(entry.nameOffset) + entry.nameSize > header->nameSize ||
+            entry.dataOffset > fileSize || entry.dataSize > fileSize - entry.dataOffset ||
+            entry.kind > Kind::Pixels ||
+            (entry.kind == Kind::Pixels && pixelBytes != entry.dataSize)) {
+            return reject("entry out of bounds");
+        }
+        m_index.emplace(std::string_view(names + entry.nameOffset, entry.nameSize), &entry);
+    }
+
+    m_header = header;
+    return true;
+}
+
+void AssetPack::close()
+{
+    m_header = nullptr;
+    m_index.clear();
+    m_file.close();
+}
+
+const AssetPack::Entry *AssetPack::find(const std::string &name) const
+{
+    auto it = m_index.find(name);
+    return it != m_index.end() ? it->second : nullptr;
+}
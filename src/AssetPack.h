@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "MappedFile.h"
+
+// Every file of the assets directory bundled into one file (see tools/AssetPacker.cpp). Images
+// are stored already decoded as RGBA8, so loading one is a copy out of the mapping instead of
+// a PNG decode. Everything else (fonts, configs) is stored byte for byte.
+//
+//   Header | Entry records | Name bytes | Data, every entry's data 16 byte aligned
+class AssetPack
+{
+public:
+    static constexpr uint32_t MAGIC = 0x50415653; // "SVAP"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t ENDIAN_CHECK = 0x01020304;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t endianCheck;
+        uint32_t entryCount;
+        uint64_t totalSize;
+        uint32_t entryOffset;
+        uint32_t nameOffset;
+        uint32_t nameSize;
+        uint32_t reserved;
+    };
+
+    enum class Kind : uint32_t
+    {
+        Raw,   // the file as it is on disk
+        Pixels // width * height RGBA8 pixels
+    };
+
+    struct Entry
+    {
+        uint32_t nameOffset; // into the name bytes, relative to the assets directory
+        uint32_t nameSize;
+        Kind kind;
+        uint32_t width; // Pixels only
+        uint32_t height;
+        uint32_t reserved;
+        uint64_t dataOffset;
+        uint64_t dataSize;
+    };
+
+    // Packer side: bundles every regular file under directory, images decoded
+    static bool write(const std::string &directory, const std::string &path);
+
+    // Maps the pack and checks magic, version and that every entry is in bounds
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    // nullptr if the pack has no file of that name
+    const Entry *find(const std::string &name) const;
+    const uint8_t *getData(const Entry &entry) const { return m_file.data() + entry.dataOffset; }
+    size_t getEntryCount() const { return m_index.size(); }
+
+private:
+    MappedFile m_file;
+    const Header *m_header{nullptr};
+    std::unordered_map<std::string_view, const Entry *> m_index; // names point into the mapping
+};
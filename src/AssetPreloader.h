@@ -0,0 +1,53 @@
+#pragma once
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <ostream>
+#include <vector>
+
+#include "AssetManifest.h"
+
+// A manifest entry after decoding
+struct LoadedAsset
+{
+    AssetEntry entry;
+    bool loaded{false};
+    sf::Image image; // Kind::Texture
+    sf::Font font;   // Kind::Font
+    double decodeMs{0.0};
+};
+
+// Decodes every asset of a manifest on worker threads. Only CPU work happens there (PNG and
+// font parsing, or copies out of the asset pack); creating GPU textures is left to the main
+// thread.
+class AssetPreloader
+{
+public:
+    AssetPreloader() = default;
+    ~AssetPreloader() { wait(); }
+
+    AssetPreloader(const AssetPreloader &) = delete;
+    AssetPreloader &operator=(const AssetPreloader &) = delete;
+
+    // One task per asset, they run while the caller does other startup work
+    void start(const AssetManifest &manifest);
+    // Blocks until every task is done, false if any asset failed to load
+    bool wait();
+
+    size_t getCompletedCount() const { return m_completed.load(); }
+    size_t getTotalCount() const { return m_assets.size(); }
+
+    // Valid after wait()
+    const std::vector<LoadedAsset> &getAssets() const { return m_assets; }
+    // Per asset decode times, plus the wall time of the whole batch
+    void printReport(std::ostream &out) const;
+
+private:
+    std::vector<LoadedAsset> m_assets;
+    std::vector<std::future<void>> m_tasks;
+    std::atomic<size_t> m_completed{0};
+    double m_wallMs{0.0};
+    std::chrono::steady_clock::time_point m_start;
+};
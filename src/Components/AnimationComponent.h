@@ -1,34 +1,43 @@
 #pragma once
-#include <SFML/Graphics.hpp>
-#include <unordered_map>
+#include <cstdint>
 #include "../Types.h"
-#include "../Config/GameConfig.h"
+#include "../Config/AnimationLibrary.h"
 #include "Component.h"
 
-struct AnimData
-{
-    std::vector<sf::IntRect> frames;
-    sf::Time frameDuration = sf::Time::Zero;
-    bool loop = true;
-};
-
 class AnimationComponent : public Component
 {
 public:
-    AnimationComponent() = default;
+    // The clips are shared by every entity of a type, nothing is copied on spawn
+    explicit AnimationComponent(const AnimationSet &set);
     ~AnimationComponent() = default;
 
-    // setup
-    void addAnimation(EntityState state, const AnimationInfo &animInfo);
+    bool hasAnimation(EntityState state) const
+    {
+        return set->getClipId(state) != AnimationSet::NO_CLIP;
+    }
+    // Only valid when hasAnimation(state)
+    const AnimationClip &getClip(EntityState state) const
+    {
+        return AnimationLibrary::getInstance().getClip(set->getClipId(state));
+    }
+
+    // Config reload: the set's clips were rebuilt, start over from the default state
+    void restart()
+    {
+        defaultState = set->defaultState;
+        requestedState = set->defaultState;
+        currentState = EntityState::NOTHING;
+        currentFrame = 0;
+        isPlaying = false;
+    }
 
-    std::unordered_map<EntityState, AnimData> animations;
+    const AnimationSet *set;
     EntityState defaultState{EntityState::NOTHING};
 
-    // State
+    // State, the frame timer itself is kept by the AnimationSystem
     EntityState requestedState{EntityState::NOTHING};
     EntityState currentState{EntityState::NOTHING};
-    size_t currentFrame{0};
-    sf::Time currentTime{sf::Time::Zero};
+    uint32_t currentFrame{0};
     bool isPlaying{false};
 
     virtual const char *getName() const override { return "AnimationComponent"; }
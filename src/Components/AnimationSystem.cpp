@@ -5,21 +5,90 @@
 
 void AnimationSystem::update(float dt, std::vector<std::unique_ptr<Entity>> &entities)
 {
-    for (auto &entity : entities) {
+    registerEntities(entities);
+
+    // State requests come from gameplay code, so they are read back from the components
+    for (size_t slot = 0; slot < m_owners.size(); slot++) {
+        handleStateTransition(slot);
+    }
+
+    advanceFrames(sf::seconds(dt).asMicroseconds());
+    applyChanges();
+}
+
+void AnimationSystem::registerEntities(std::vector<std::unique_ptr<Entity>> &entities)
+{
+    if (entities.size() < m_scannedEntities) {
+        // The entity list was rebuilt, start over
+        m_owners.clear();
+        m_visuals.clear();
+        m_time.clear();
+        m_duration.clear();
+        m_frame.clear();
+        m_frameCount.clear();
+        m_firstFrame.clear();
+        m_loop.clear();
+        m_active.clear();
+        m_finished.clear();
+        m_dirty.clear();
+        m_scannedEntities = 0;
+    }
+
+    for (; m_scannedEntities < entities.size(); m_scannedEntities++) {
+        Entity *entity = entities[m_scannedEntities].get();
         auto *anim = entity->getComponent<AnimationComponent>();
         auto *visual = entity->getComponent<VisualComponent>();
-
-        if (!anim || !visual || !anim->isEnabled()) {
+        if (!anim || !visual) {
             continue;
         }
-        handleStateTransition(anim);
-        updateFrame(dt, anim);
-        applyToVisual(anim, visual);
+        m_owners.push_back(anim);
+        m_visuals.push_back(visual);
+        m_time.push_back(0);
+        m_duration.push_back(0);
+        m_frame.push_back(0);
+        m_frameCount.push_back(0);
+        m_firstFrame.push_back(0);
+        m_loop.push_back(0);
+        m_active.push_back(0);
+        m_finished.push_back(0);
+        m_dirty.push_back(0);
+    }
+
+    m_changed.resize(m_owners.size());
+}
+
+void AnimationSystem::resetClips()
+{
+    for (size_t slot = 0; slot < m_owners.size(); slot++) {
+        AnimationComponent *anim = m_owners[slot];
+        // Components restarted by the reload already request their default state
+        if (anim->requestedState == EntityState::NOTHING) {
+            anim->requestedState = anim->currentState;
+        }
+        anim->currentState = EntityState::NOTHING;
+        anim->currentFrame = 0;
+        anim->isPlaying = false;
+
+        m_time[slot] = 0;
+        m_duration[slot] = 0;
+        m_frame[slot] = 0;
+        m_frameCount[slot] = 0;
+        m_firstFrame[slot] = 0;
+        m_loop[slot] = 0;
+        m_active[slot] = 0;
+        m_finished[slot] = 0;
+        m_dirty[slot] = 0;
     }
 }
 
-void AnimationSystem::handleStateTransition(AnimationComponent *anim) const
+void AnimationSystem::handleStateTransition(size_t slot)
 {
+    AnimationComponent *anim = m_owners[slot];
+    m_active[slot] = anim->isEnabled() && anim->isPlaying && m_frameCount[slot] > 0;
+    if (!anim->isEnabled()) {
+        return;
+    }
+
     if (anim->requestedState == EntityState::NOTHING ||
         anim->requestedState == anim->currentState) {
 
@@ -27,76 +96,91 @@ void AnimationSystem::handleStateTransition(AnimationComponent *anim) const
         return;
     }
 
-    bool canChange = true;
-    if (anim->currentState != EntityState::NOTHING && anim->animations.count(anim->currentState)) {
-        const auto &currentAnimData = anim->animations.at(anim->currentState);
-        // not interrupting non-looping animations
-        if (!currentAnimData.loop && anim->isPlaying) {
-            canChange = false;
-        }
-    }
-
-    // Check if a new state has been requested
-    if (anim->requestedState == EntityState::NOTHING || !canChange) {
+    // not interrupting non-looping animations
+    if (anim->isPlaying && anim->hasAnimation(anim->currentState) &&
+        !anim->getClip(anim->currentState).loop) {
         return;
     }
 
     // Apply the new state
-    if (anim->animations.count(anim->requestedState)) {
+    if (anim->hasAnimation(anim->requestedState)) {
+        const AnimationClip &clip = anim->getClip(anim->requestedState);
         anim->currentState = anim->requestedState;
-        anim->currentTime = sf::Time::Zero;
         anim->currentFrame = 0;
         anim->isPlaying = true;
+
+        m_time[slot] = 0;
+        m_duration[slot] = clip.frameDuration.asMicroseconds();
+        m_frame[slot] = 0;
+        m_frameCount[slot] = clip.frameCount;
+        m_firstFrame[slot] = clip.firstFrame;
+        m_loop[slot] = clip.loop;
+        m_active[slot] = clip.frameCount > 0;
+        m_dirty[slot] = clip.frameCount > 0;
     }
 
     // 'consume' the requested state
     anim->requestedState = EntityState::NOTHING;
 }
 
-void AnimationSystem::updateFrame(float dt, AnimationComponent *anim) const
+void AnimationSystem::advanceFrames(int64_t step)
 {
-    // Check if there is animation to play
-    if (!anim->isPlaying || !anim->animations.count(anim->currentState)) {
-        return;
-    }
+    // Branch free so it vectorises: inactive slots add nothing and never advance, a frame
+    // that wraps back onto itself (single frame loops) does not count as a change
+    const size_t count = m_owners.size();
+    for (size_t i = 0; i < count; i++) {
+        const int64_t active = m_active[i];
+        const int64_t time = m_time[i] + (step & -active);
+        const int64_t advance = active & static_cast<int64_t>(time >= m_duration[i]);
+        m_time[i] = time - (m_duration[i] & -advance);
 
-    // Check if there is any frames
-    const auto &data = anim->animations.at(anim->currentState);
-    if (data.frames.empty()) {
-        return;
-    }
+        // Slots without a clip yet have no frames, they stay on frame 0 and never turn dirty
+        const uint32_t hasFrames = m_frameCount[i] != 0;
+        const uint32_t next = m_frame[i] + static_cast<uint32_t>(advance);
+        const uint32_t over = next >= m_frameCount[i];
+        const uint32_t last = m_frameCount[i] - hasFrames;
+        const uint32_t wrapped = m_loop[i] ? 0u : last;
+        const uint32_t frame = over ? wrapped : next;
+        const uint8_t finished = static_cast<uint8_t>(over & advance & (m_loop[i] ^ 1));
 
-    // Play the animation / update frames
-    anim->currentTime += sf::seconds(dt);
-    if (anim->currentTime >= data.frameDuration) {
-        anim->currentTime -= data.frameDuration;
-        anim->currentFrame++;
-
-        // Check if animation finished
-        if (anim->currentFrame >= data.frames.size()) {
-            if (data.loop) {
-                // loop back
-                anim->currentFrame = 0;
-            }
-            else {
-                // stay on last frame but request a change
-                anim->currentFrame = data.frames.size() - 1;
-                anim->isPlaying = false;
-                anim->requestedState = anim->defaultState;
-            }
-        }
+        m_dirty[i] |= static_cast<uint8_t>(((frame != m_frame[i]) | finished) & hasFrames);
+        m_finished[i] = finished;
+        m_frame[i] = frame;
     }
 }
 
-void AnimationSystem::applyToVisual(AnimationComponent *anim, VisualComponent *visual) const
+void AnimationSystem::applyChanges()
 {
-    if (!anim->animations.count(anim->currentState)) {
-        return;
+    // Compact the dirty slots into a list
+    size_t changed = 0;
+    const size_t count = m_owners.size();
+    for (size_t i = 0; i < count; i++) {
+        m_changed[changed] = static_cast<uint32_t>(i);
+        changed += m_dirty[i];
+        m_dirty[i] = 0;
     }
 
-    const auto &data = anim->animations.at(anim->currentState);
+    const AnimationLibrary &library = AnimationLibrary::getInstance();
+    for (size_t n = 0; n < changed; n++) {
+        const uint32_t i = m_changed[n];
+        AnimationComponent *anim = m_owners[i];
+        anim->currentFrame = m_frame[i];
+
+        if (m_finished[i]) {
+            // stay on last frame but request a change
+            anim->isPlaying = false;
+            anim->requestedState = anim->defaultState;
+        }
+
+        m_visuals[i]->setTextureRect(library.getFrame(m_firstFrame[i] + m_frame[i]));
+    }
 
-    if (!data.frames.empty() && anim->currentFrame < data.frames.size()) {
-        visual->setTextureRect(data.frames[anim->currentFrame]);
+    size_t active = 0;
+    for (size_t i = 0; i < count; i++) {
+        active += m_active[i];
     }
+    m_rectUpdates = changed;
+    m_skippedUpdates = active > changed ? active - changed : 0;
+    m_totalRectUpdates += m_rectUpdates;
+    m_totalSkippedUpdates += m_skippedUpdates;
 }
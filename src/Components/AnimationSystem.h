@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <memory>
 
@@ -6,6 +7,9 @@ class Entity;
 class AnimationComponent;
 class VisualComponent;
 
+// Advances every animation in one pass over flat arrays and only touches the visuals whose
+// frame actually changed. Playback timers live here; the components hold the requested and
+// current state and a mirror of the current frame.
 class AnimationSystem
 {
 public:
@@ -14,8 +18,43 @@ public:
 
     void update(float dt, std::vector<std::unique_ptr<Entity>> &entities);
 
+    // Config reload: AnimationLibrary rebuilt its frame array, so every slot drops its clip and
+    // asks for its state again to pick up the new one
+    void resetClips();
+
+    size_t getAnimatedCount() const { return m_owners.size(); }
+    // Texture rect updates made / skipped because the frame did not change, last update
+    size_t getRectUpdateCount() const { return m_rectUpdates; }
+    size_t getSkippedUpdateCount() const { return m_skippedUpdates; }
+    // The same, summed over every update so far
+    uint64_t getTotalRectUpdateCount() const { return m_totalRectUpdates; }
+    uint64_t getTotalSkippedUpdateCount() const { return m_totalSkippedUpdates; }
+
 private:
-    void handleStateTransition(AnimationComponent *anim) const;
-    void updateFrame(float dt, AnimationComponent *anim) const;
-    void applyToVisual(AnimationComponent *anim, VisualComponent *visual) const;
+    // Picks up animated entities spawned since the last update
+    void registerEntities(std::vector<std::unique_ptr<Entity>> &entities);
+    void handleStateTransition(size_t slot);
+    void advanceFrames(int64_t step);
+    void applyChanges();
+
+    size_t m_scannedEntities{0};
+
+    // One slot per animated entity, never released since entities are never destroyed
+    std::vector<AnimationComponent *> m_owners;
+    std::vector<VisualComponent *> m_visuals;
+    std::vector<int64_t> m_time;     // microseconds into the current frame
+    std::vector<int64_t> m_duration; // microseconds per frame of the current clip
+    std::vector<uint32_t> m_frame;
+    std::vector<uint32_t> m_frameCount;
+    std::vector<uint32_t> m_firstFrame; // into AnimationLibrary's frame array
+    std::vector<uint8_t> m_loop;
+    std::vector<uint8_t> m_active;   // enabled and playing this update
+    std::vector<uint8_t> m_finished; // a one-shot clip ran out this update
+    std::vector<uint8_t> m_dirty;    // frame or clip changed this update
+
+    std::vector<uint32_t> m_changed;
+    size_t m_rectUpdates{0};
+    size_t m_skippedUpdates{0};
+    uint64_t m_totalRectUpdates{0};
+    uint64_t m_totalSkippedUpdates{0};
 };
@@ -7,72 +7,209 @@
 #include "HealthComponent.h"
 #include "OwnerComponent.h"
 #include "../MathUtils.h"
+#include "../DebugDraw.h"
+#include "../Profiler.h"
+#include <algorithm>
 #include <limits>
+#include <utility>
 #include <cmath>
 #include <iostream>
 
 void CollisionSystem::update(float deltaTime, std::vector<std::unique_ptr<Entity>> &entities)
 {
-    // Reset collision state for all entities
-    for (auto &entity : entities) {
-        if (auto *collision = entity->getComponent<CollisionComponent>()) {
-            collision->isColliding = false;
-        }
+    buildBroadphase(entities);
+    solvePairs(entities);
+
+    if (m_debugDraw && m_debugDraw->isAnyEnabled()) {
+        PROFILE_SCOPE("Collision::debug");
+        emitDebug(entities);
     }
+}
 
+void CollisionSystem::buildBroadphase(const std::vector<std::unique_ptr<Entity>> &entities)
+{
+    PROFILE_SCOPE("Collision::broadphase");
+
+    // Reset collision state for all entities and bucket the enabled colliders
+    m_broadphase.clear();
+    m_colliders.clear();
     for (size_t i = 0; i < entities.size(); i++) {
+        auto *collision = entities[i]->getComponent<CollisionComponent>();
+        if (!collision) {
+            continue;
+        }
+        collision->isColliding = false;
+
+        auto *transform = entities[i]->getComponent<TransformComponent>();
+        if (transform && collision->isEnabled()) {
+            m_colliders.push_back(i);
+            if (m_broadphaseEnabled) {
+                m_broadphase.insert(i, getBounds(*collision, *transform));
+            }
+        }
+    }
+}
+
+void CollisionSystem::solvePairs(std::vector<std::unique_ptr<Entity>> &entities)
+{
+    // Each pair is resolved before the next one is tested, so narrowphase and resolution
+    // interleave and are timed as two sums rather than two scopes
+    PROFILE_SCOPE("Collision::pairs");
+    PROFILE_SUM(narrowphase, "Collision::narrowphase");
+    PROFILE_SUM_AFTER(resolution, "Collision::resolution", narrowphase);
+    m_events.clear();
+    m_pairCount = 0;
+
+    // Returns whether the pair was pushed apart
+    auto solvePair = [&](size_t i, size_t j) {
+        m_pairCount++;
         auto *collision1 = entities[i]->getComponent<CollisionComponent>();
         auto *transform1 = entities[i]->getComponent<TransformComponent>();
-        if (!collision1 || !transform1 || !collision1->isEnabled())
-            continue;
+        auto *collision2 = entities[j]->getComponent<CollisionComponent>();
+        auto *transform2 = entities[j]->getComponent<TransformComponent>();
 
-        for (size_t j = i + 1; j < entities.size(); j++) {
-            auto *collision2 = entities[j]->getComponent<CollisionComponent>();
-            auto *transform2 = entities[j]->getComponent<TransformComponent>();
-            if (!collision2 || !transform2 || !collision2->isEnabled())
-                continue;
+        auto *kin1 = entities[i]->getComponent<KinematicsComponent>();
+        auto *kin2 = entities[j]->getComponent<KinematicsComponent>();
+        if (!kin1 && !kin2) {
+            return false;
+        }
+        if (kin1 && kin1->isStatic && kin2 && kin2->isStatic) {
+            return false;
+        }
 
-            auto *kin1 = entities[i]->getComponent<KinematicsComponent>();
-            auto *kin2 = entities[j]->getComponent<KinematicsComponent>();
-            if (!kin1 && !kin2) {
-                continue;
+        CollisionResult result{};
+        {
+            PROFILE_SUM_SCOPE(narrowphase);
+            result = checkCollision(*collision1, *transform1, *collision2, *transform2);
+        }
+        if (!result.intersects) {
+            return false;
+        }
+
+        PROFILE_SUM_SCOPE(resolution);
+        skipPhysics = false;
+        CollisionEvent::Type outcome = processCombat(entities[i].get(), entities[j].get());
+        if (skipPhysics) {
+            if (outcome != CollisionEvent::Contact) {
+                sf::Vector2f point =
+                    (getCenter(*collision1, *transform1) + getCenter(*collision2, *transform2)) /
+                    2.f;
+                m_events.push_back({outcome, point, result.normal, result.depth, 0.f});
             }
-            if (kin1 && kin1->isStatic && kin2 && kin2->isStatic) {
-                continue;
+            return false;
+        }
+        collision1->isColliding = true;
+        collision2->isColliding = true;
+
+        sf::Vector2f velocity1 = kin1 ? kin1->velocity : sf::Vector2f(0.f, 0.f);
+        sf::Vector2f velocity2 = kin2 ? kin2->velocity : sf::Vector2f(0.f, 0.f);
+        sf::Vector2f point =
+            (getCenter(*collision1, *transform1) + getCenter(*collision2, *transform2)) / 2.f;
+        m_events.push_back({CollisionEvent::Contact, point, result.normal, result.depth,
+                            DotProduct(velocity1 - velocity2, result.normal)});
+
+        float mass1 = kin1 ? kin1->mass : std::numeric_limits<float>::infinity();
+        float mass2 = kin2 ? kin2->mass : std::numeric_limits<float>::infinity();
+
+        if (std::isinf(mass1) && std::isinf(mass2)) {
+            handleStaticStaticCollision(entities[i].get(), entities[j].get(), result.normal,
+                                        result.depth);
+        }
+        else if (std::isinf(mass1)) {
+            handleStaticDynamicCollision(entities[i].get(), entities[j].get(), result.normal,
+                                         result.depth);
+        }
+        else if (std::isinf(mass2)) {
+            handleStaticDynamicCollision(entities[j].get(), entities[i].get(), -result.normal,
+                                         result.depth);
+        }
+        else {
+            handleDynamicDynamicCollision(entities[i].get(), entities[j].get(), result.normal,
+                                          result.depth);
+        }
+        return true;
+    };
+
+    auto boundsOf = [&](size_t index) {
+        return getBounds(*entities[index]->getComponent<CollisionComponent>(),
+                         *entities[index]->getComponent<TransformComponent>());
+    };
+
+    if (!m_broadphaseEnabled) {
+        for (size_t a = 0; a < m_colliders.size(); a++) {
+            for (size_t b = a + 1; b < m_colliders.size(); b++) {
+                solvePair(m_colliders[a], m_colliders[b]);
             }
+        }
+        return;
+    }
 
-            CollisionResult result =
-                checkCollision(*collision1, *transform1, *collision2, *transform2);
-
-            if (result.intersects) {
-                skipPhysics = false;
-                processCombat(entities[i].get(), entities[j].get());
-                if (skipPhysics) {
+    // Same pairs in the same order as the sweep, minus those whose bounds do not overlap, which
+    // the narrowphase would reject without side effects. Bodies pushed apart are moved in the
+    // grid straight away, and i is queried again from its new bounds, so every later pair sees
+    // current positions exactly like the sweep does.
+    for (size_t i : m_colliders) {
+        size_t last = i;
+        bool moved = true;
+        while (moved) {
+            moved = false;
+            const sf::FloatRect bounds = boundsOf(i);
+            m_broadphase.query(bounds, m_candidates);
+            auto it = std::upper_bound(m_candidates.begin(), m_candidates.end(), last);
+            for (; it != m_candidates.end() && !moved; ++it) {
+                const size_t j = *it;
+                last = j;
+                if (!solvePair(i, j)) {
                     continue;
                 }
-                collision1->isColliding = true;
-                collision2->isColliding = true;
+                const sf::FloatRect newBounds = boundsOf(i);
+                m_broadphase.update(i, newBounds);
+                m_broadphase.update(j, boundsOf(j));
+                moved = newBounds != bounds;
+            }
+        }
+    }
+}
 
-                float mass1 = kin1 ? kin1->mass : std::numeric_limits<float>::infinity();
-                float mass2 = kin2 ? kin2->mass : std::numeric_limits<float>::infinity();
+void CollisionSystem::emitDebug(const std::vector<std::unique_ptr<Entity>> &entities)
+{
+    if (m_broadphaseEnabled && m_debugDraw->isEnabled(DebugDraw::BroadphaseCells)) {
+        const sf::Color cellColor(255, 255, 0, 60);
+        m_broadphase.forEachCell(
+            [&](const sf::FloatRect &cell, size_t) { m_debugDraw->addRect(cell, cellColor); });
+    }
+
+    if (m_debugDraw->isEnabled(DebugDraw::Colliders)) {
+        // Outlines reflect the resolved positions of this tick
+        for (const auto &entity : entities) {
+            auto *collision = entity->getComponent<CollisionComponent>();
+            auto *transform = entity->getComponent<TransformComponent>();
+            if (!collision || !transform || !collision->isEnabled()) {
+                continue;
+            }
+            const sf::Color outline = collision->isColliding ? sf::Color::Red : sf::Color::White;
+            if (collision->type == CollisionShape::Circle) {
+                m_debugDraw->addCircle(getCenter(*collision, *transform),
+                                       getWorldRadius(*collision, *transform),
+                                       collision->debugColor, outline);
+            }
+            else {
+                std::vector<sf::Vector2f> points = getWorldPoints(*collision, *transform);
+                m_debugDraw->addPolygon(points.data(), points.size(), collision->debugColor,
+                                        outline);
+            }
+        }
+    }
 
-                if (std::isinf(mass1) && std::isinf(mass2)) {
-                    handleStaticStaticCollision(entities[i].get(), entities[j].get(), result.normal,
-                                                result.depth);
-                }
-                else if (std::isinf(mass1)) {
-                    handleStaticDynamicCollision(entities[i].get(), entities[j].get(),
-                                                 result.normal, result.depth);
-                }
-                else if (std::isinf(mass2)) {
-                    handleStaticDynamicCollision(entities[j].get(), entities[i].get(),
-                                                 -result.normal, result.depth);
-                }
-                else {
-                    handleDynamicDynamicCollision(entities[i].get(), entities[j].get(),
-                                                  result.normal, result.depth);
-                }
+    if (m_debugDraw->isEnabled(DebugDraw::ContactNormals)) {
+        const sf::Color normalColor(255, 200, 0);
+        for (const auto &contact : m_events) {
+            if (contact.type != CollisionEvent::Contact) {
+                continue;
             }
+            m_debugDraw->addLine(contact.point,
+                                 contact.point + contact.normal * (10.f + contact.depth),
+                                 normalColor, 2.f);
         }
     }
 }
@@ -215,28 +352,33 @@ sf::FloatRect CollisionSystem::getBounds(const CollisionComponent &col,
     }
 }
 
-void CollisionSystem::processCombat(Entity *entityA, Entity *entityB)
+CollisionEvent::Type CollisionSystem::processCombat(Entity *entityA, Entity *entityB)
 {
+    CollisionEvent::Type outcome = CollisionEvent::Contact;
+
     // Get components for A attacking B
     auto *weaponA = entityA->getComponent<WeaponComponent>();
     auto *healthB = entityB->getComponent<HealthComponent>();
-    auto *ownerA = entityA->getComponent<OwnerComponent>();
-    auto *ownerB = entityB->getComponent<OwnerComponent>();
+    const auto *ownerA = std::as_const(*entityA).getComponent<OwnerComponent>();
+    const auto *ownerB = std::as_const(*entityB).getComponent<OwnerComponent>();
 
     // Check for friendly fire
     if (ownerA && ownerA->owner == entityB) {
         skipPhysics = true;
-        return;
+        return outcome;
     }
     if (ownerA && ownerB && ownerA->owner == ownerB->owner) {
         skipPhysics = true;
-        return;
+        return outcome;
     }
 
     // Check for A attacking B
     if (weaponA && healthB) {
         skipPhysics = true;
+        bool wasAlive = healthB->currentHealth > 0.f;
         healthB->currentHealth -= weaponA->damage;
+        outcome = wasAlive && healthB->currentHealth <= 0.f ? CollisionEvent::Kill
+                                                             : CollisionEvent::Hit;
         std::cout << "Entity B health: " << healthB->currentHealth << std::endl;
         // TODO: Handle entity death, piercing and other stats
     }
@@ -248,15 +390,22 @@ void CollisionSystem::processCombat(Entity *entityA, Entity *entityB)
     // Check for friendly fire (weapon's owner is not A)
     if (ownerB && ownerB->owner == entityA) {
         skipPhysics = true;
-        return;
+        return outcome;
     }
     // Check for B attacking A
     if (weaponB && healthA) {
         skipPhysics = true;
+        bool wasAlive = healthA->currentHealth > 0.f;
         healthA->currentHealth -= weaponB->damage;
+        if (wasAlive && healthA->currentHealth <= 0.f)
+            outcome = CollisionEvent::Kill;
+        else if (outcome == CollisionEvent::Contact)
+            outcome = CollisionEvent::Hit;
         std::cout << "Entity A health: " << healthA->currentHealth << std::endl;
         // TODO: Handle entity death, piercing and other stats
     }
+
+    return outcome;
 }
 
 /**
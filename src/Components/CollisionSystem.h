@@ -4,11 +4,30 @@
 #include <memory>
 #include <vector>
 #include "../Config/GameConfig.h"
+#include "../SpatialGrid.h"
 
 class Entity;
+class DebugDraw;
 class CollisionComponent;
 class TransformComponent;
 
+// A resolved contact or a weapon hit from the last update
+struct CollisionEvent
+{
+    enum Type
+    {
+        Contact,
+        Hit,
+        Kill,
+    };
+
+    Type type;
+    sf::Vector2f point;
+    sf::Vector2f normal; // from the first entity towards the second
+    float depth;
+    float speed; // closing speed along the normal before resolution, 0 for hits
+};
+
 class CollisionSystem
 {
 public:
@@ -18,9 +37,37 @@ public:
     // Main update loop
     void update(float deltaTime, std::vector<std::unique_ptr<Entity>> &entities);
 
+    // Pairs of enabled colliders tested in the last update, with overlapping bounds when the
+    // broadphase is on
+    size_t getCandidatePairCount() const { return m_pairCount; }
+    const std::vector<CollisionEvent> &getEvents() const { return m_events; }
+
+    void setDebugDraw(DebugDraw *debugDraw) { m_debugDraw = debugDraw; }
+
+    // Off, every pair of enabled colliders is tested as in a full sweep. Both give the same
+    // results, the sweep is kept as the reference to check the broadphase against.
+    void setBroadphaseEnabled(bool enabled) { m_broadphaseEnabled = enabled; }
+
 private:
-    // Combat handling
-    void processCombat(Entity *entityA, Entity *entityB);
+    // Buckets the enabled colliders into the grid by their bounds
+    void buildBroadphase(const std::vector<std::unique_ptr<Entity>> &entities);
+    // Tests pairs of enabled colliders in i < j order. Each pair sees the positions left by the
+    // pairs resolved before it, so a body pushed into a new contact is handled this update.
+    void solvePairs(std::vector<std::unique_ptr<Entity>> &entities);
+    // Writes colliders, contacts and broadphase cells into the debug buffer
+    void emitDebug(const std::vector<std::unique_ptr<Entity>> &entities);
+    DebugDraw *m_debugDraw{nullptr};
+    std::vector<CollisionEvent> m_events;
+    size_t m_pairCount{0};
+
+    // Broadphase, rebuilt from collider bounds every update and kept current while solving
+    bool m_broadphaseEnabled{true};
+    SpatialGrid m_broadphase;
+    std::vector<size_t> m_colliders; // enabled colliders, ascending
+    std::vector<size_t> m_candidates;
+
+    // Combat handling, returns Hit or Kill when damage was dealt and Contact otherwise
+    CollisionEvent::Type processCombat(Entity *entityA, Entity *entityB);
     bool skipPhysics{false};
     // Collision resolution logic
     void handleStaticDynamicCollision(Entity *staticEntity, Entity *dynamicEntity,
@@ -3,22 +3,37 @@
 #include <typeindex>
 #include <unordered_map>
 #include "Component.h"
+#include "../SystemAccess.h"
 
+// In debug builds a lookup made while a scheduled system runs is checked against what the system
+// declared: through a const container as a read, otherwise as a write, see SystemAccess.h
 class ComponentContainer
 {
 public:
     template <typename T, typename... Args> T &addComponent(Args &&...args)
     {
         static_assert(std::is_base_of<Component, T>::value, "T must inherit from Component");
+        SURVIVE_CHECK_WRITE(T);
         auto component = std::make_shared<T>(std::forward<Args>(args)...);
         T &componentRef = *component;
         components[typeid(T)] = std::move(component);
         return componentRef;
     }
 
+    // Takes a component that is already constructed, e.g. a slot of a bulk allocation
+    template <typename T> T &adoptComponent(std::shared_ptr<T> component)
+    {
+        static_assert(std::is_base_of<Component, T>::value, "T must inherit from Component");
+        SURVIVE_CHECK_WRITE(T);
+        T &componentRef = *component;
+        components[typeid(T)] = std::move(component);
+        return componentRef;
+    }
+
     template <typename T> T *getComponent()
     {
         static_assert(std::is_base_of<Component, T>::value, "T must inherit from Component");
+        SURVIVE_CHECK_WRITE(T);
         auto it = components.find(typeid(T));
         return it != components.end() ? static_cast<T *>(it->second.get()) : nullptr;
     }
@@ -26,6 +41,7 @@ public:
     template <typename T> const T *getComponent() const
     {
         static_assert(std::is_base_of<Component, T>::value, "T must inherit from Component");
+        SURVIVE_CHECK_READ(T);
         auto it = components.find(typeid(T));
         return it != components.end() ? static_cast<const T *>(it->second.get()) : nullptr;
     }
@@ -45,5 +45,18 @@ public:
         , isStatic(data.isStatic)
     {}
 
+    // Config reload: tuning values only. Velocity and acceleration are left to the simulation,
+    // mass and isStatic to Entity::setMass and setStatic, new values reach new entities only.
+    void applyConfig(const KinematicsComponentData &data)
+    {
+        angularAcceleration = data.angularAcceleration;
+        behavior = data.behavior;
+        orbitRadius = data.orbitRadius;
+        orbitAngularVelocity = data.orbitAngularVelocity;
+        pulseFrequency = data.pulseFrequency;
+        pulseAmplitude = data.pulseAmplitude;
+        drag = data.drag;
+    }
+
     virtual const char *getName() const override { return "KinematicsComponent"; }
 };
@@ -5,6 +5,7 @@
 #include "DirectionComponent.h"
 #include "OwnerComponent.h"
 #include "../MathUtils.h"
+#include <utility>
 
 void KinematicsSystem::update(float dt, std::vector<std::unique_ptr<Entity>> &entities)
 {
@@ -104,8 +105,9 @@ void KinematicsSystem::handleFacingDirection(KinematicsComponent *kinematics,
 
     // Priority 1: Match Owner's Facing (if Attached)
     if (hasFlag(kinematics->behavior, KinematicsBehavior::Attached)) {
-        if (auto *owner = entity->getComponent<OwnerComponent>()) {
-            if (auto *ownerDir = owner->owner->getComponent<DirectionComponent>()) {
+        if (const auto *owner = std::as_const(*entity).getComponent<OwnerComponent>()) {
+            if (const auto *ownerDir =
+                    std::as_const(*owner->owner).getComponent<DirectionComponent>()) {
                 dir->setFacing(ownerDir->getFacing());
             }
         }
@@ -160,8 +162,9 @@ void KinematicsSystem::handleRotation(float dt, KinematicsComponent *kinematics,
     }
     // Priority 2: Match Owner's Rotation (if Attached)
     else if (hasFlag(kinematics->behavior, KinematicsBehavior::Attached)) {
-        if (auto *owner = entity->getComponent<OwnerComponent>()) {
-            if (auto *ownerTransform = owner->owner->getComponent<TransformComponent>()) {
+        if (const auto *owner = std::as_const(*entity).getComponent<OwnerComponent>()) {
+            if (const auto *ownerTransform =
+                    std::as_const(*owner->owner).getComponent<TransformComponent>()) {
                 transform->rotation = ownerTransform->rotation;
             }
         }
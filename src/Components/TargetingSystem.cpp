@@ -3,17 +3,20 @@
 #include "OwnerComponent.h"
 #include "TransformComponent.h"
 #include "KinematicsComponent.h"
+#include <utility>
 
 void TargetingSystem::update(std::vector<std::unique_ptr<Entity>> &entities)
 {
     for (const auto &entity : entities) {
-        // All following is owner based, so check for owner and owner's transform
-        auto *owner = entity->getComponent<OwnerComponent>();
+        // All following is owner based, so check for owner and owner's transform. Both are only
+        // read, so they are looked up through const entities.
+        const auto *owner = std::as_const(*entity).getComponent<OwnerComponent>();
         if (!owner || !owner->owner) {
             continue;
         }
         // Get the owner's transform
-        auto *ownerTransform = owner->owner->getComponent<TransformComponent>();
+        const auto *ownerTransform =
+            std::as_const(*owner->owner).getComponent<TransformComponent>();
         if (!ownerTransform) {
             continue;
         }
@@ -1,43 +1,65 @@
 #pragma once
 #include "Component.h"
-#include "../ResourceManager.h"
+#include "../TextureAtlas.h"
 #include "../Config/GameConfig.h"
-#include <iostream>
 
 class VisualComponent : public Component, public sf::Drawable
 {
 public:
     VisualComponent(const VisualComponentData &data)
     {
-        if (!data.filename.empty()) {
-            if (!m_texture.loadFromFile(ResourceManager::getFilePath(data.filename))) {
-                std::cerr << "Unable to load texture, creating a bank texture" << std::endl;
-                m_texture.create(1, 1);
-                sf::Color color = sf::Color::White;
-                sf::Uint8 whitePixel[4] = {color.r, color.g, color.b, color.a};
-                m_texture.update(whitePixel);
-                m_texture.setRepeated(true);
-            }
-        }
-        m_sprite.setTexture(m_texture);
+        // Sheets live in the shared atlas, the sprite only points at its region
+        const AtlasRegion &region = TextureAtlas::getInstance().getRegion(data.filename);
+        m_atlasPage = region.page;
+        m_sprite.setTexture(TextureAtlas::getInstance().getTexture(m_atlasPage));
+        m_sprite.setTextureRect(region.rect);
         m_sprite.scale(data.scale);
         m_sprite.setOrigin(data.origin);
         m_sprite.setPosition(data.offset);
         m_sprite.setRotation(data.rotation);
+        m_layer = data.layer;
+        m_ySort = data.ySort;
     }
     ~VisualComponent() = default;
 
+    // Config reload: the sheet stays the same, only its placement changes
+    void applyConfig(const VisualComponentData &data)
+    {
+        m_sprite.setScale(data.scale);
+        m_sprite.setOrigin(data.origin);
+        m_sprite.setPosition(data.offset);
+        m_sprite.setRotation(data.rotation);
+        m_layer = data.layer;
+        m_ySort = data.ySort;
+    }
+
     virtual void draw(sf::RenderTarget &target, sf::RenderStates states) const override
     {
         target.draw(m_sprite, states);
     }
+
+    // World space bounding box of the sprite under the given entity transform
+    sf::FloatRect getBounds(const sf::Transform &transform) const
+    {
+        return (transform * m_sprite.getTransform()).transformRect(m_sprite.getLocalBounds());
+    }
+
+    const sf::Transform &getSpriteTransform() const { return m_sprite.getTransform(); }
+    const sf::IntRect &getTextureRect() const { return m_sprite.getTextureRect(); }
+    const sf::Color &getColor() const { return m_sprite.getColor(); }
+
     void setTextureRect(const sf::IntRect &rect) { m_sprite.setTextureRect(rect); }
     void setScale(const sf::Vector2f &scale) { m_sprite.setScale(scale); }
     const sf::Vector2f &getScale() const { return m_sprite.getScale(); }
+    size_t getAtlasPage() const { return m_atlasPage; }
+    RenderLayer getLayer() const { return m_layer; }
+    bool isYSorted() const { return m_ySort; }
 
     virtual const char *getName() const override { return "VisualComponent"; }
 
 private:
     sf::Sprite m_sprite;
-    sf::Texture m_texture;
+    size_t m_atlasPage{0};
+    RenderLayer m_layer{RenderLayer::Characters};
+    bool m_ySort{false};
 };
@@ -17,5 +17,13 @@ public:
         , lifetime(data.lifetime)
     {}
 
+    void applyConfig(const WeaponComponentData &data)
+    {
+        damage = data.damage;
+        piercing = data.piercing;
+        maxHits = data.maxHits;
+        lifetime = data.lifetime;
+    }
+
     virtual const char *getName() const override { return "WeaponComponent"; }
 };
@@ -0,0 +1,69 @@
+#include "AnimationLibrary.h"
+#include "EntityManager.h"
+#include "../TextureAtlas.h"
+
+void AnimationLibrary::build()
+{
+    // Sets are reset in place, components keep pointing at them across rebuilds
+    m_frames.clear();
+    m_clips.clear();
+    for (AnimationSet &set : m_sets) {
+        set.clips.fill(AnimationSet::NO_CLIP);
+        set.defaultState = EntityState::NOTHING;
+    }
+
+    const EntityConfigTable &configs = EntityManager::getInstance().getConfigs();
+    for (size_t type = 0; type < ENTITY_TYPE_COUNT; type++) {
+        if (!configs[type].has_value()) {
+            continue;
+        }
+        const EntityConfig &config = *configs[type];
+
+        // Sheet frame rects are remapped into the atlas region of the type's sheet
+        sf::Vector2i atlasOffset{0, 0};
+        if (config.visual.has_value()) {
+            const AtlasRegion &region =
+                TextureAtlas::getInstance().getRegion(config.visual->filename);
+            atlasOffset = {region.rect.left, region.rect.top};
+        }
+
+        AnimationSet &set = m_sets[type];
+
+        for (int state = 0; state < ENTITY_STATE_COUNT; state++) {
+            if (!config.animations[state].has_value()) {
+                continue;
+            }
+            const AnimationInfo &info = *config.animations[state];
+
+            set.clips[state] = static_cast<int32_t>(m_clips.size());
+            m_clips.push_back({static_cast<uint32_t>(m_frames.size()),
+                               static_cast<uint32_t>(info.frameCount), info.frameDuration,
+                               info.loop});
+
+            for (size_t i = 0; i < info.frameCount; i++) {
+                m_frames.emplace_back(atlasOffset.x + info.startPos.x + i * info.frameSize.x,
+                                      atlasOffset.y + info.startPos.y * info.frameSize.y,
+                                      info.frameSize.x, info.frameSize.y);
+            }
+        }
+
+        // Idle when there is one, otherwise the first state with a clip
+        if (set.clips[EntityState::IDLE] != AnimationSet::NO_CLIP) {
+            set.defaultState = EntityState::IDLE;
+        }
+        else {
+            for (int state = 0; state < ENTITY_STATE_COUNT; state++) {
+                if (set.clips[state] != AnimationSet::NO_CLIP) {
+                    set.defaultState = static_cast<EntityState>(state);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+const AnimationSet *AnimationLibrary::getSet(EntityType type) const
+{
+    const AnimationSet &set = m_sets[toIndex(type)];
+    return set.defaultState == EntityState::NOTHING ? nullptr : &set;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Time.hpp>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "../Types.h"
+
+// A run of frames in AnimationLibrary's flat frame array
+struct AnimationClip
+{
+    uint32_t firstFrame;
+    uint32_t frameCount;
+    sf::Time frameDuration;
+    bool loop;
+};
+
+// Clip ids of one entity type, indexed by EntityState
+struct AnimationSet
+{
+    static constexpr int32_t NO_CLIP = -1;
+
+    std::array<int32_t, ENTITY_STATE_COUNT> clips;
+    EntityState defaultState{EntityState::NOTHING};
+
+    int32_t getClipId(EntityState state) const
+    {
+        return state >= 0 && state < ENTITY_STATE_COUNT ? clips[state] : NO_CLIP;
+    }
+};
+
+// Frame rects for every animated EntityType, built once from EntityConfig::animations and
+// shared by all instances, only rebuilt on config reload. Frames are stored in atlas space, so
+// the atlas has to be built before the library is first used.
+class AnimationLibrary
+{
+public:
+    static AnimationLibrary &getInstance()
+    {
+        static AnimationLibrary instance;
+        return instance;
+    }
+
+    // Rebuilds every clip from the current configs, after a config reload
+    void rebuild() { build(); }
+
+    // nullptr if the type has no animations
+    const AnimationSet *getSet(EntityType type) const;
+
+    const AnimationClip &getClip(int32_t id) const { return m_clips[id]; }
+    const sf::IntRect &getFrame(uint32_t index) const
+    {
+        assert(index < m_frames.size() && "frame outside the frame array");
+        return m_frames[index];
+    }
+
+    AnimationLibrary(const AnimationLibrary &) = delete;
+    AnimationLibrary &operator=(const AnimationLibrary &) = delete;
+
+private:
+    AnimationLibrary() { build(); }
+    void build();
+
+    std::vector<sf::IntRect> m_frames;
+    std::vector<AnimationClip> m_clips;
+    std::array<AnimationSet, ENTITY_TYPE_COUNT> m_sets{};
+};
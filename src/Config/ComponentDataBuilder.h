@@ -30,9 +30,19 @@ public:
         m_rotation = rotation;
         return *this;
     }
+    VisualDataBuilder &setLayer(RenderLayer layer)
+    {
+        m_layer = layer;
+        return *this;
+    }
+    VisualDataBuilder &setYSort(bool ySort)
+    {
+        m_ySort = ySort;
+        return *this;
+    }
     VisualComponentData build() const
     {
-        return {m_filename, m_scale, m_origin, m_offset, m_rotation};
+        return {m_filename, m_scale, m_origin, m_offset, m_rotation, m_layer, m_ySort};
     }
 
 private:
@@ -41,6 +51,8 @@ private:
     sf::Vector2f m_origin{0.f, 0.f};
     sf::Vector2f m_offset{0.f, 0.f};
     float m_rotation{0.f};
+    RenderLayer m_layer{RenderLayer::Characters};
+    bool m_ySort{false};
 };
 
 class CollisionDataBuilder
@@ -53,7 +65,7 @@ public:
         m_origin = {radius, radius};
         return *this;
     }
-    CollisionDataBuilder &setPolygon(const std::vector<sf::Vector2f> &points)
+    CollisionDataBuilder &setPolygon(const PolygonPoints &points)
     {
         m_type = CollisionShape::Polygon;
         m_points = points;
@@ -101,7 +113,7 @@ public:
 private:
     CollisionShape m_type{CollisionShape::Polygon};
     float m_radius{0.f};
-    std::vector<sf::Vector2f> m_points;
+    PolygonPoints m_points;
     sf::Vector2f m_scale{1.f, 1.f};
     sf::Vector2f m_origin{0.f, 0.f};
     sf::Vector2f m_offset{0.f, 0.f};
@@ -0,0 +1,336 @@
+#include "ConfigBlob.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    constexpr size_t ALIGNMENT = 8;
+
+    size_t align(size_t size)
+    {
+        return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    void copyVector(float *out, const sf::Vector2f &vector)
+    {
+        out[0] = vector.x;
+        out[1] = vector.y;
+    }
+
+    sf::Vector2f toVector(const float *values)
+    {
+        return {values[0], values[1]};
+    }
+
+    // A section of count records starting at offset fits inside the file and is aligned
+    bool sectionFits(uint32_t offset, uint64_t count, size_t recordSize, size_t fileSize)
+    {
+        return offset % alignof(uint64_t) == 0 && offset <= fileSize &&
+               count * recordSize <= fileSize - offset;
+    }
+} // namespace
+
+static_assert(sizeof(ConfigBlob::Header) % 8 == 0, "blob header must keep 8 byte alignment");
+static_assert(sizeof(ConfigBlob::Entity) % 4 == 0, "entity records must keep 4 byte alignment");
+static_assert(sizeof(ConfigBlob::Animation) % 8 == 0, "animation records must keep 8 byte alignment");
+
+uint64_t ConfigBlob::hash(const uint8_t *data, size_t size)
+{
+    uint64_t value = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        value ^= data[i];
+        value *= 1099511628211ull;
+    }
+    return value;
+}
+
+std::vector<uint8_t> ConfigBlob::serialize(const EntityConfigTable &configs, uint64_t sourceHash)
+{
+    std::vector<Entity> entities;
+    std::vector<Point> points;
+    std::vector<Animation> animations;
+    std::string strings;
+
+    // Walked in type order, so the same configs always produce the same bytes
+    for (size_t type = 0; type < ENTITY_TYPE_COUNT; type++) {
+        if (!configs[type].has_value()) {
+            continue;
+        }
+        const EntityConfig &config = *configs[type];
+        Entity entity;
+        std::memset(&entity, 0, sizeof(entity));
+        entity.type = static_cast<uint32_t>(type);
+
+        if (config.visual.has_value()) {
+            const VisualComponentData &data = config.visual.value();
+            entity.flags |= HasVisual;
+            entity.visual.filenameOffset = static_cast<uint32_t>(strings.size());
+            entity.visual.filenameSize = static_cast<uint32_t>(data.filename.size());
+            strings += data.filename;
+            copyVector(entity.visual.scale, data.scale);
+            copyVector(entity.visual.origin, data.origin);
+            copyVector(entity.visual.offset, data.offset);
+            entity.visual.rotation = data.rotation;
+            entity.visual.layer = static_cast<uint8_t>(data.layer);
+            entity.visual.ySort = data.ySort;
+        }
+
+        if (config.collision.has_value()) {
+            const CollisionComponentData &data = config.collision.value();
+            entity.flags |= HasCollision;
+            entity.collision.shape = static_cast<uint32_t>(data.type);
+            entity.collision.radius = data.radius;
+            entity.collision.firstPoint = static_cast<uint32_t>(points.size());
+            entity.collision.pointCount = static_cast<uint32_t>(data.points.size());
+            for (const sf::Vector2f &point : data.points) {
+                points.push_back({point.x, point.y});
+            }
+            copyVector(entity.collision.scale, data.scale);
+            copyVector(entity.collision.origin, data.origin);
+            copyVector(entity.collision.offset, data.offset);
+            entity.collision.rotation = data.rotation;
+            entity.collision.debugColor[0] = data.debugColor.r;
+            entity.collision.debugColor[1] = data.debugColor.g;
+            entity.collision.debugColor[2] = data.debugColor.b;
+            entity.collision.debugColor[3] = data.debugColor.a;
+        }
+
+        if (config.kinematics.has_value()) {
+            const KinematicsComponentData &data = config.kinematics.value();
+            entity.flags |= HasKinematics;
+            copyVector(entity.kinematics.velocity, data.velocity);
+            copyVector(entity.kinematics.acceleration, data.acceleration);
+            entity.kinematics.angularVelocity = data.angularVelocity;
+            entity.kinematics.angularAcceleration = data.angularAcceleration;
+            copyVector(entity.kinematics.scaleVelocity, data.scaleVelocity);
+            entity.kinematics.behavior = static_cast<uint32_t>(data.behavior);
+            entity.kinematics.orbitRadius = data.orbitRadius;
+            entity.kinematics.orbitAngularVelocity = data.orbitAngularVelocity;
+            entity.kinematics.pulseFrequency = data.pulseFrequency;
+            entity.kinematics.pulseAmplitude = data.pulseAmplitude;
+            entity.kinematics.drag = data.drag;
+            entity.kinematics.mass = data.mass;
+            entity.kinematics.isStatic = data.isStatic;
+        }
+
+        if (config.weapon.has_value()) {
+            const WeaponComponentData &data = config.weapon.value();
+            entity.flags |= HasWeapon;
+            entity.weapon = {data.damage, data.piercing, data.maxHits, data.lifetime};
+        }
+
+        entity.firstAnimation = static_cast<uint32_t>(animations.size());
+        for (int state = 0; state < ENTITY_STATE_COUNT; state++) {
+            if (!config.animations[state].has_value()) {
+                continue;
+            }
+            const AnimationInfo &info = *config.animations[state];
+            Animation animation;
+            std::memset(&animation, 0, sizeof(animation));
+            animation.frameDuration = info.frameDuration.asMicroseconds();
+            animation.state = state;
+            animation.frameSize[0] = info.frameSize.x;
+            animation.frameSize[1] = info.frameSize.y;
+            animation.startPos[0] = info.startPos.x;
+            animation.startPos[1] = info.startPos.y;
+            animation.frameCount = static_cast<uint32_t>(info.frameCount);
+            animation.loop = info.loop;
+            animations.push_back(animation);
+        }
+        entity.animationCount = static_cast<uint32_t>(animations.size()) - entity.firstAnimation;
+
+        entities.push_back(entity);
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.endianCheck = ENDIAN_CHECK;
+    header.sourceHash = sourceHash;
+
+    size_t offset = align(sizeof(Header));
+    header.entityOffset = static_cast<uint32_t>(offset);
+    header.entityCount = static_cast<uint32_t>(entities.size());
+    offset = align(offset + entities.size() * sizeof(Entity));
+    header.pointOffset = static_cast<uint32_t>(offset);
+    header.pointCount = static_cast<uint32_t>(points.size());
+    offset = align(offset + points.size() * sizeof(Point));
+    header.animationOffset = static_cast<uint32_t>(offset);
+    header.animationCount = static_cast<uint32_t>(animations.size());
+    offset = align(offset + animations.size() * sizeof(Animation));
+    header.stringOffset = static_cast<uint32_t>(offset);
+    header.stringSize = static_cast<uint32_t>(strings.size());
+    offset = align(offset + strings.size());
+    header.totalSize = static_cast<uint32_t>(offset);
+
+    std::vector<uint8_t> bytes(offset, 0);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    if (!entities.empty())
+        std::memcpy(bytes.data() + header.entityOffset, entities.data(),
+                    entities.size() * sizeof(Entity));
+    if (!points.empty())
+        std::memcpy(bytes.data() + header.pointOffset, points.data(), points.size() * sizeof(Point));
+    if (!animations.empty())
+        std::memcpy(bytes.data() + header.animationOffset, animations.data(),
+                    animations.size() * sizeof(Animation));
+    if (!strings.empty())
+        std::memcpy(bytes.data() + header.stringOffset, strings.data(), strings.size());
+    return bytes;
+}
+
+bool ConfigBlob::write(const std::string &path, const EntityConfigTable &configs,
+                       uint64_t sourceHash)
+{
+    std::vector<uint8_t> bytes = serialize(configs, sourceHash);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char *>(bytes.data()), bytes.size())) {
+        std::cerr << "Unable to write config blob " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ConfigBlob::open(const std::string &path)
+{
+    close();
+    if (!m_file.open(path)) {
+        return false;
+    }
+
+    auto reject = [this, &path](const char *reason) {
+        std::cerr << "Ignoring config blob " << path << ": " << reason << std::endl;
+        close();
+        return false;
+    };
+
+    if (m_file.size() < sizeof(Header)) {
+        return reject("truncated");
+    }
+    const Header *header = section<Header>(0);
+    if (header->magic != MAGIC) {
+        return reject("not a config blob");
+    }
+    if (header->endianCheck != ENDIAN_CHECK) {
+        return reject("written on a machine with a different byte order");
+    }
+    if (header->version != VERSION) {
+        return reject("version mismatch, recompile it");
+    }
+    if (header->totalSize != m_file.size() ||
+        !sectionFits(header->entityOffset, header->entityCount, sizeof(Entity), m_file.size()) ||
+        !sectionFits(header->pointOffset, header->pointCount, sizeof(Point), m_file.size()) ||
+        !sectionFits(header->animationOffset, header->animationCount, sizeof(Animation),
+                     m_file.size()) ||
+        !sectionFits(header->stringOffset, header->stringSize, 1, m_file.size())) {
+        return reject("section out of bounds");
+    }
+
+    // Cross references are checked once here, decode can then trust them
+    const Entity *entities = section<Entity>(header->entityOffset);
+    for (uint32_t i = 0; i < header->entityCount; i++) {
+        const Entity &entity = entities[i];
+        if (entity.type >= ENTITY_TYPE_COUNT || entity.collision.pointCount > MAX_POLYGON_POINTS) {
+            return reject("record out of range");
+        }
+        if (uint64_t(entity.firstAnimation) + entity.animationCount > header->animationCount ||
+            uint64_t(entity.collision.firstPoint) + entity.collision.pointCount >
+                header->pointCount ||
+            uint64_t(entity.visual.filenameOffset) + entity.visual.filenameSize >
+                header->stringSize) {
+            return reject("record out of bounds");
+        }
+    }
+
+    m_header = header;
+    return true;
+}
+
+void ConfigBlob::close()
+{
+    m_header = nullptr;
+    m_file.close();
+}
+
+void ConfigBlob::decode(EntityConfigTable &configs) const
+{
+    const Entity *entities = section<Entity>(m_header->entityOffset);
+    const Point *points = section<Point>(m_header->pointOffset);
+    const Animation *animations = section<Animation>(m_header->animationOffset);
+    const char *strings = section<char>(m_header->stringOffset);
+
+    for (uint32_t i = 0; i < m_header->entityCount; i++) {
+        const Entity &entity = entities[i];
+        EntityConfig config;
+
+        if (entity.flags & HasVisual) {
+            const Visual &visual = entity.visual;
+            config.visual = VisualComponentData{
+                std::string(strings + visual.filenameOffset, visual.filenameSize),
+                toVector(visual.scale),
+                toVector(visual.origin),
+                toVector(visual.offset),
+                visual.rotation,
+                static_cast<RenderLayer>(visual.layer),
+                visual.ySort != 0};
+        }
+
+        if (entity.flags & HasCollision) {
+            const Collision &collision = entity.collision;
+            const Point *first = points + collision.firstPoint;
+            PolygonPoints localPoints;
+            for (uint32_t p = 0; p < collision.pointCount; p++) {
+                localPoints.push_back({first[p].x, first[p].y});
+            }
+            config.collision = CollisionComponentData{
+                static_cast<CollisionShape>(collision.shape),
+                collision.radius,
+                localPoints,
+                toVector(collision.scale),
+                toVector(collision.origin),
+                toVector(collision.offset),
+                collision.rotation,
+                sf::Color(collision.debugColor[0], collision.debugColor[1],
+                          collision.debugColor[2], collision.debugColor[3])};
+        }
+
+        if (entity.flags & HasKinematics) {
+            const Kinematics &kinematics = entity.kinematics;
+            config.kinematics = KinematicsComponentData{
+                toVector(kinematics.velocity),
+                toVector(kinematics.acceleration),
+                kinematics.angularVelocity,
+                kinematics.angularAcceleration,
+                toVector(kinematics.scaleVelocity),
+                static_cast<KinematicsBehavior>(kinematics.behavior),
+                kinematics.orbitRadius,
+                kinematics.orbitAngularVelocity,
+                kinematics.pulseFrequency,
+                kinematics.pulseAmplitude,
+                kinematics.drag,
+                kinematics.mass,
+                kinematics.isStatic != 0};
+        }
+
+        if (entity.flags & HasWeapon) {
+            const Weapon &weapon = entity.weapon;
+            config.weapon =
+                WeaponComponentData{weapon.damage, weapon.piercing, weapon.maxHits, weapon.lifetime};
+        }
+
+        for (uint32_t a = 0; a < entity.animationCount; a++) {
+            const Animation &animation = animations[entity.firstAnimation + a];
+            if (animation.state < 0 || animation.state >= ENTITY_STATE_COUNT) {
+                continue;
+            }
+            config.animations[animation.state] = AnimationInfo{
+                sf::Vector2i(animation.frameSize[0], animation.frameSize[1]),
+                sf::Vector2i(animation.startPos[0], animation.startPos[1]),
+                animation.frameCount, sf::microseconds(animation.frameDuration),
+                animation.loop != 0};
+        }
+
+        configs[entity.type] = std::move(config);
+    }
+}
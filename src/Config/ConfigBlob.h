@@ -0,0 +1,152 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GameConfig.h"
+#include "../MappedFile.h"
+
+// Entity configs compiled into one flat, versioned binary file (see tools/ConfigCompiler.cpp).
+// Every record has a fixed layout and refers to shared arrays by offset from the start of the
+// file, so the file is used exactly as mapped: nothing is tokenised or parsed at load time.
+//
+//   Header | Entity records | Polygon points | Animation records | String bytes
+class ConfigBlob
+{
+public:
+    static constexpr uint32_t MAGIC = 0x42435653; // "SVCB"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t ENDIAN_CHECK = 0x01020304;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t endianCheck;
+        uint32_t totalSize;
+        uint64_t sourceHash; // of the text the blob was compiled from, 0 if none
+        uint32_t entityOffset;
+        uint32_t entityCount;
+        uint32_t pointOffset;
+        uint32_t pointCount;
+        uint32_t animationOffset;
+        uint32_t animationCount;
+        uint32_t stringOffset;
+        uint32_t stringSize;
+    };
+
+    enum EntityFlags : uint32_t
+    {
+        HasVisual = 1 << 0,
+        HasCollision = 1 << 1,
+        HasKinematics = 1 << 2,
+        HasWeapon = 1 << 3,
+    };
+
+    struct Visual
+    {
+        uint32_t filenameOffset; // into the string bytes
+        uint32_t filenameSize;
+        float scale[2];
+        float origin[2];
+        float offset[2];
+        float rotation;
+        uint8_t layer;
+        uint8_t ySort;
+        uint8_t padding[2];
+    };
+
+    struct Collision
+    {
+        uint32_t shape;
+        float radius;
+        uint32_t firstPoint;
+        uint32_t pointCount;
+        float scale[2];
+        float origin[2];
+        float offset[2];
+        float rotation;
+        uint8_t debugColor[4];
+    };
+
+    struct Kinematics
+    {
+        float velocity[2];
+        float acceleration[2];
+        float angularVelocity;
+        float angularAcceleration;
+        float scaleVelocity[2];
+        uint32_t behavior;
+        float orbitRadius;
+        float orbitAngularVelocity;
+        float pulseFrequency;
+        float pulseAmplitude;
+        float drag;
+        float mass;
+        uint32_t isStatic;
+    };
+
+    struct Weapon
+    {
+        float damage;
+        int32_t piercing;
+        int32_t maxHits;
+        float lifetime;
+    };
+
+    struct Entity
+    {
+        uint32_t type;
+        uint32_t flags;
+        uint32_t firstAnimation;
+        uint32_t animationCount;
+        Visual visual;
+        Collision collision;
+        Kinematics kinematics;
+        Weapon weapon;
+    };
+
+    struct Animation
+    {
+        int64_t frameDuration; // microseconds
+        int32_t state;
+        int32_t frameSize[2];
+        int32_t startPos[2];
+        uint32_t frameCount;
+        uint32_t loop;
+        uint32_t padding;
+    };
+
+    struct Point
+    {
+        float x;
+        float y;
+    };
+
+    // Compiler side
+    static std::vector<uint8_t> serialize(const EntityConfigTable &configs, uint64_t sourceHash);
+    static bool write(const std::string &path, const EntityConfigTable &configs,
+                      uint64_t sourceHash);
+    // FNV-1a, identifies the text a blob was compiled from
+    static uint64_t hash(const uint8_t *data, size_t size);
+
+    // Loader side: maps the file and checks magic, version and that every section is in bounds
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    uint64_t getSourceHash() const { return m_header->sourceHash; }
+    size_t getEntityCount() const { return m_header->entityCount; }
+
+    // Fills configs from the records, types in the blob replace what configs held
+    void decode(EntityConfigTable &configs) const;
+
+private:
+    template <typename T> const T *section(uint32_t offset) const
+    {
+        return reinterpret_cast<const T *>(m_file.data() + offset);
+    }
+
+    MappedFile m_file;
+    const Header *m_header{nullptr};
+};
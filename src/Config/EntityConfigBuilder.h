@@ -42,7 +42,7 @@ public:
 private:
     std::optional<VisualComponentData> m_visual;
     std::optional<CollisionComponentData> m_collision;
-    std::unordered_map<EntityState, AnimationInfo> m_animations;
+    AnimationTable m_animations;
     std::optional<WeaponComponentData> m_weapon;
     std::optional<KinematicsComponentData> m_kinematics;
 };
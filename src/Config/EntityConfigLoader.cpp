@@ -0,0 +1,500 @@
+#include "EntityConfigLoader.h"
+#include "ComponentDataBuilder.h"
+#include "EntityConfigBuilder.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <vector>
+
+namespace {
+    struct TypeName
+    {
+        EntityType type;
+        const char *name;
+    };
+    const TypeName TYPE_NAMES[] = {
+        {EntityType::PLAYER, "PLAYER"},
+        {EntityType::TOWER, "TOWER"},
+        {EntityType::LASER_WEAPON, "LASER_WEAPON"},
+        {EntityType::EXPLOSION_WEAPON, "EXPLOSION_WEAPON"},
+        {EntityType::CONE_WEAPON, "CONE_WEAPON"},
+        {EntityType::VAMPIRE, "VAMPIRE"},
+        {EntityType::TEST_BOX, "TEST_BOX"},
+        {EntityType::WALL_HORIZONTAL, "WALL_HORIZONTAL"},
+        {EntityType::WALL_VERTICAL, "WALL_VERTICAL"},
+    };
+
+    const char *STATE_NAMES[ENTITY_STATE_COUNT] = {"IDLE",      "MOVE_UP",   "MOVE_RIGHT",
+                                                   "MOVE_DOWN", "MOVE_LEFT", "WEAPON_1"};
+
+    struct BehaviorName
+    {
+        KinematicsBehavior behavior;
+        const char *name;
+    };
+    const BehaviorName BEHAVIOR_NAMES[] = {
+        {KinematicsBehavior::None, "None"},
+        {KinematicsBehavior::Linear, "Linear"},
+        {KinematicsBehavior::Accelerate, "Accelerate"},
+        {KinematicsBehavior::Homing, "Homing"},
+        {KinematicsBehavior::Orbital, "Orbital"},
+        {KinematicsBehavior::Rotating, "Rotating"},
+        {KinematicsBehavior::Extending, "Extending"},
+        {KinematicsBehavior::Pulsing, "Pulsing"},
+        {KinematicsBehavior::FaceTarget, "FaceTarget"},
+        {KinematicsBehavior::Attached, "Attached"},
+    };
+
+    const char *LAYER_NAMES[] = {"Ground", "Characters", "Weapons", "Effects"};
+
+    std::string trim(const std::string &text)
+    {
+        size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            return std::string();
+        }
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    std::vector<std::string> split(const std::string &text, char separator)
+    {
+        std::vector<std::string> parts;
+        std::stringstream stream(text);
+        std::string part;
+        while (std::getline(stream, part, separator)) {
+            parts.push_back(trim(part));
+        }
+        return parts;
+    }
+
+    // Whitespace separated numbers, all of which must parse
+    bool parseFloats(const std::string &text, float *out, size_t count)
+    {
+        const char *cursor = text.c_str();
+        for (size_t i = 0; i < count; i++) {
+            char *end = nullptr;
+            out[i] = std::strtof(cursor, &end);
+            if (end == cursor) {
+                return false;
+            }
+            cursor = end;
+        }
+        return trim(cursor).empty();
+    }
+
+    bool parseFloat(const std::string &text, float &out) { return parseFloats(text, &out, 1); }
+
+    bool parseInt(const std::string &text, int &out)
+    {
+        float value;
+        if (!parseFloat(text, value)) {
+            return false;
+        }
+        out = static_cast<int>(value);
+        return static_cast<float>(out) == value;
+    }
+
+    bool parseVector(const std::string &text, sf::Vector2f &out)
+    {
+        float values[2];
+        if (!parseFloats(text, values, 2)) {
+            return false;
+        }
+        out = {values[0], values[1]};
+        return true;
+    }
+
+    bool parseVectorInt(const std::string &text, sf::Vector2i &out)
+    {
+        sf::Vector2f value;
+        if (!parseVector(text, value)) {
+            return false;
+        }
+        out = sf::Vector2i(static_cast<int>(value.x), static_cast<int>(value.y));
+        return true;
+    }
+
+    bool parseBool(const std::string &text, bool &out)
+    {
+        if (text == "true" || text == "1") {
+            out = true;
+            return true;
+        }
+        if (text == "false" || text == "0") {
+            out = false;
+            return true;
+        }
+        return false;
+    }
+
+    bool parseColor(const std::string &text, sf::Color &out)
+    {
+        float values[4];
+        if (!parseFloats(text, values, 4)) {
+            // The failed attempt may have written a 0 alpha already, "r g b" is opaque
+            if (!parseFloats(text, values, 3)) {
+                return false;
+            }
+            values[3] = 255.f;
+        }
+        out = sf::Color(static_cast<sf::Uint8>(values[0]), static_cast<sf::Uint8>(values[1]),
+                        static_cast<sf::Uint8>(values[2]), static_cast<sf::Uint8>(values[3]));
+        return true;
+    }
+
+    // Comma separated "x y" pairs, at most MAX_POLYGON_POINTS of them
+    bool parsePoints(const std::string &text, PolygonPoints &out)
+    {
+        out.clear();
+        for (const std::string &pair : split(text, ',')) {
+            sf::Vector2f point;
+            if (!parseVector(pair, point) || !out.push_back(point)) {
+                return false;
+            }
+        }
+        return out.size() >= 3;
+    }
+
+    // Names joined with '|', e.g. "Rotating | Orbital"
+    bool parseBehavior(const std::string &text, KinematicsBehavior &out)
+    {
+        out = KinematicsBehavior::None;
+        for (const std::string &name : split(text, '|')) {
+            bool found = false;
+            for (const auto &entry : BEHAVIOR_NAMES) {
+                if (name == entry.name) {
+                    out = out | entry.behavior;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool parseLayer(const std::string &text, RenderLayer &out)
+    {
+        for (size_t i = 0; i < sizeof(LAYER_NAMES) / sizeof(LAYER_NAMES[0]); i++) {
+            if (text == LAYER_NAMES[i]) {
+                out = static_cast<RenderLayer>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool parseType(const std::string &text, EntityType &out)
+    {
+        for (const auto &entry : TYPE_NAMES) {
+            if (text == entry.name) {
+                out = entry.type;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool parseState(const std::string &text, EntityState &out)
+    {
+        for (int state = 0; state < ENTITY_STATE_COUNT; state++) {
+            if (text == STATE_NAMES[state]) {
+                out = static_cast<EntityState>(state);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // "frameWidth frameHeight, startColumn startRow, frameCount, frameMilliseconds, loop|once"
+    bool parseAnimation(const std::string &text, AnimationInfo &out)
+    {
+        std::vector<std::string> parts = split(text, ',');
+        if (parts.size() != 5) {
+            return false;
+        }
+        sf::Vector2i frameSize, startPos;
+        int frameCount, milliseconds;
+        if (!parseVectorInt(parts[0], frameSize) || !parseVectorInt(parts[1], startPos) ||
+            !parseInt(parts[2], frameCount) || !parseInt(parts[3], milliseconds) ||
+            frameCount <= 0 || (parts[4] != "loop" && parts[4] != "once")) {
+            return false;
+        }
+        out = AnimationInfoBuilder()
+                  .setFrameSize(frameSize)
+                  .setStartPos(startPos)
+                  .setFrameCount(static_cast<size_t>(frameCount))
+                  .setFrameDuration(sf::milliseconds(milliseconds))
+                  .setLoop(parts[4] == "loop")
+                  .build();
+        return true;
+    }
+
+    // Builders for the section being read, a component exists once any of its keys appear
+    struct Section
+    {
+        EntityType type;
+        std::optional<VisualDataBuilder> visual;
+        std::optional<CollisionDataBuilder> collision;
+        std::optional<KinematicsDataBuilder> kinematics;
+        std::optional<WeaponDataBuilder> weapon;
+        EntityConfigBuilder config;
+
+        EntityConfig build()
+        {
+            if (visual)
+                config.setVisual(visual->build());
+            if (collision)
+                config.setCollision(collision->build());
+            if (kinematics)
+                config.setKinematics(kinematics->build());
+            if (weapon)
+                config.setWeapon(weapon->build());
+            return config.build();
+        }
+    };
+
+    bool applyVisual(VisualDataBuilder &builder, const std::string &field, const std::string &value)
+    {
+        sf::Vector2f vector;
+        float number;
+        bool flag;
+        RenderLayer layer;
+        if (field == "filename")
+            builder.setFilename(value);
+        else if (field == "scale" && parseVector(value, vector))
+            builder.setScale(vector);
+        else if (field == "origin" && parseVector(value, vector))
+            builder.setOrigin(vector);
+        else if (field == "offset" && parseVector(value, vector))
+            builder.setOffset(vector);
+        else if (field == "rotation" && parseFloat(value, number))
+            builder.setRotation(number);
+        else if (field == "layer" && parseLayer(value, layer))
+            builder.setLayer(layer);
+        else if (field == "ySort" && parseBool(value, flag))
+            builder.setYSort(flag);
+        else
+            return false;
+        return true;
+    }
+
+    bool applyCollision(CollisionDataBuilder &builder, const std::string &field,
+                        const std::string &value)
+    {
+        sf::Vector2f vector;
+        PolygonPoints points;
+        float number;
+        sf::Color color;
+        if (field == "circle" && parseFloat(value, number))
+            builder.setCircle(number);
+        else if (field == "box" && parseVector(value, vector))
+            builder.setBox(vector);
+        else if (field == "polygon" && parsePoints(value, points))
+            builder.setPolygon(points);
+        else if (field == "scale" && parseVector(value, vector))
+            builder.setScale(vector);
+        else if (field == "origin" && parseVector(value, vector))
+            builder.setOrigin(vector);
+        else if (field == "offset" && parseVector(value, vector))
+            builder.setOffset(vector);
+        else if (field == "rotation" && parseFloat(value, number))
+            builder.setRotation(number);
+        else if (field == "debugColor" && parseColor(value, color))
+            builder.setDebugColor(color);
+        else
+            return false;
+        return true;
+    }
+
+    bool applyKinematics(KinematicsDataBuilder &builder, const std::string &field,
+                         const std::string &value)
+    {
+        sf::Vector2f vector;
+        float number;
+        bool flag;
+        KinematicsBehavior behavior;
+        if (field == "velocity" && parseVector(value, vector))
+            builder.setVelocity(vector);
+        else if (field == "acceleration" && parseVector(value, vector))
+            builder.setAcceleration(vector);
+        else if (field == "angularVelocity" && parseFloat(value, number))
+            builder.setAngularVelocity(number);
+        else if (field == "angularAcceleration" && parseFloat(value, number))
+            builder.setAngularAcceleration(number);
+        else if (field == "scaleVelocity" && parseVector(value, vector))
+            builder.setScaleVelocity(vector);
+        else if (field == "behavior" && parseBehavior(value, behavior))
+            builder.setBehavior(behavior);
+        else if (field == "orbitRadius" && parseFloat(value, number))
+            builder.setOrbitRadius(number);
+        else if (field == "orbitAngularVelocity" && parseFloat(value, number))
+            builder.setOrbitAngularVelocity(number);
+        else if (field == "pulseFrequency" && parseFloat(value, number))
+            builder.setPulseFrequency(number);
+        else if (field == "pulseAmplitude" && parseFloat(value, number))
+            builder.setPulseAmplitude(number);
+        else if (field == "drag" && parseFloat(value, number))
+            builder.setDrag(number);
+        else if (field == "mass" && parseFloat(value, number)) // "inf" for immovable
+            builder.setMass(number);
+        else if (field == "static" && parseBool(value, flag))
+            builder.setStatic(flag);
+        else
+            return false;
+        return true;
+    }
+
+    bool applyWeapon(WeaponDataBuilder &builder, const std::string &field, const std::string &value)
+    {
+        float number;
+        int integer;
+        if (field == "damage" && parseFloat(value, number))
+            builder.setDamage(number);
+        else if (field == "piercing" && parseInt(value, integer))
+            builder.setPiercing(integer);
+        else if (field == "maxHits" && parseInt(value, integer))
+            builder.setMaxHits(integer);
+        else if (field == "lifetime" && parseFloat(value, number))
+            builder.setLifetime(number);
+        else
+            return false;
+        return true;
+    }
+
+    bool applyKey(Section &section, const std::string &key, const std::string &value)
+    {
+        size_t dot = key.find('.');
+        if (dot == std::string::npos) {
+            return false;
+        }
+        const std::string group = key.substr(0, dot);
+        const std::string field = key.substr(dot + 1);
+
+        if (group == "visual") {
+            if (!section.visual)
+                section.visual.emplace();
+            return applyVisual(*section.visual, field, value);
+        }
+        if (group == "collision") {
+            if (!section.collision)
+                section.collision.emplace();
+            return applyCollision(*section.collision, field, value);
+        }
+        if (group == "kinematics") {
+            if (!section.kinematics)
+                section.kinematics.emplace();
+            return applyKinematics(*section.kinematics, field, value);
+        }
+        if (group == "weapon") {
+            if (!section.weapon)
+                section.weapon.emplace();
+            return applyWeapon(*section.weapon, field, value);
+        }
+        if (group == "animation") {
+            EntityState state;
+            AnimationInfo info;
+            if (!parseState(field, state) || !parseAnimation(value, info)) {
+                return false;
+            }
+            section.config.addAnimation(state, info);
+            return true;
+        }
+        return false;
+    }
+} // namespace
+
+bool EntityConfigLoader::loadFromFile(const std::string &path, EntityConfigTable &configs)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Unable to open entity config " << path << std::endl;
+        return false;
+    }
+    return load(file, path, configs);
+}
+
+bool EntityConfigLoader::load(std::istream &input, const std::string &sourceName,
+                              EntityConfigTable &configs)
+{
+    EntityConfigTable loaded;
+    std::optional<Section> section;
+
+    auto error = [&sourceName](int line, const std::string &message) {
+        std::cerr << sourceName << ":" << line << ": " << message << std::endl;
+        return false;
+    };
+
+    std::string rawLine;
+    int lineNumber = 0;
+    while (std::getline(input, rawLine)) {
+        lineNumber++;
+        std::string line = trim(rawLine.substr(0, rawLine.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line.front() == '[') {
+            if (line.back() != ']') {
+                return error(lineNumber, "unterminated section header");
+            }
+            if (section) {
+                loaded[toIndex(section->type)] = section->build();
+            }
+            EntityType type;
+            if (!parseType(trim(line.substr(1, line.size() - 2)), type)) {
+                return error(lineNumber, "unknown entity type " + line);
+            }
+            if (loaded[toIndex(type)].has_value()) {
+                return error(lineNumber, "duplicate section " + line);
+            }
+            section.emplace();
+            section->type = type;
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            return error(lineNumber, "expected key = value");
+        }
+        if (!section) {
+            return error(lineNumber, "key outside of a [TYPE] section");
+        }
+        const std::string key = trim(line.substr(0, equals));
+        const std::string value = trim(line.substr(equals + 1));
+        if (!applyKey(*section, key, value)) {
+            return error(lineNumber, "bad key or value: " + line);
+        }
+    }
+    if (section) {
+        loaded[toIndex(section->type)] = section->build();
+    }
+
+    for (size_t type = 0; type < ENTITY_TYPE_COUNT; type++) {
+        if (loaded[type].has_value()) {
+            configs[type] = std::move(loaded[type]);
+        }
+    }
+    return true;
+}
+
+const char *EntityConfigLoader::getTypeName(EntityType type)
+{
+    for (const auto &entry : TYPE_NAMES) {
+        if (entry.type == type) {
+            return entry.name;
+        }
+    }
+    return "UNKNOWN";
+}
+
+const char *EntityConfigLoader::getStateName(EntityState state)
+{
+    return state >= 0 && state < ENTITY_STATE_COUNT ? STATE_NAMES[state] : "NOTHING";
+}
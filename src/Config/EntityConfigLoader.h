@@ -0,0 +1,20 @@
+#pragma once
+#include <istream>
+#include <string>
+
+#include "GameConfig.h"
+
+// Reads entity definitions from a text file, see assets/entities.cfg for the format.
+// Every [TYPE] section describes one EntityConfig with the same defaults as the builders;
+// types without a section keep their compiled-in definition.
+class EntityConfigLoader
+{
+public:
+    // On any error nothing is written to configs and the error is reported on std::cerr
+    static bool loadFromFile(const std::string &path, EntityConfigTable &configs);
+    static bool load(std::istream &input, const std::string &sourceName,
+                     EntityConfigTable &configs);
+
+    static const char *getTypeName(EntityType type);
+    static const char *getStateName(EntityState state);
+};
@@ -1,15 +1,100 @@
 #include "EntityManager.h"
-#include "GameConfig.h"
+#include "EntityConfigLoader.h"
+#include "ConfigBlob.h"
+#include "AnimationLibrary.h"
+#include "../Entity.h"
+#include "../ResourceManager.h"
+#include "../TextureAtlas.h"
+#include "../Components/TransformComponent.h"
 #include "../Components/VisualComponent.h"
 #include "../Components/CollisionComponent.h"
 #include "../Components/AnimationComponent.h"
 #include "../Components/WeaponComponent.h"
 #include "../Components/KinematicsComponent.h"
+#include "../Components/DirectionComponent.h"
+#include "../Components/HealthComponent.h"
+
+#include <filesystem>
+#include <iostream>
+
+namespace {
+    // Storage for one component type of a whole wave, allocated once. Entities share ownership
+    // of the block through aliasing shared_ptrs, so it lives as long as any of them does.
+    template <typename T> class WavePool
+    {
+    public:
+        explicit WavePool(size_t count)
+            : m_block(std::make_shared<std::vector<T>>())
+        {
+            m_block->reserve(count);
+        }
+
+        template <typename... Args> std::shared_ptr<T> add(Args &&...args)
+        {
+            m_block->emplace_back(std::forward<Args>(args)...);
+            return std::shared_ptr<T>(m_block, &m_block->back());
+        }
+
+    private:
+        std::shared_ptr<std::vector<T>> m_block;
+    };
+} // namespace
+
+void EntityManager::loadConfigs()
+{
+    configs = Config::copyEntityConfigs();
+
+    const std::string path = getConfigPath();
+
+    // A blob compiled from the same text needs no parsing at all
+    ConfigBlob blob;
+    if (blob.open(getBlobPath())) {
+        MappedFile text;
+        if (!text.open(path) || ConfigBlob::hash(text.data(), text.size()) == blob.getSourceHash()) {
+            blob.decode(configs);
+            return;
+        }
+        std::cerr << getBlobPath() << " was compiled from an older " << path
+                  << ", reading the text instead" << std::endl;
+    }
+
+    if (std::filesystem::exists(path) && !EntityConfigLoader::loadFromFile(path, configs)) {
+        std::cerr << "Using the compiled-in entity definitions" << std::endl;
+    }
+}
+
+bool EntityManager::reloadConfigs()
+{
+    EntityConfigTable reloaded = Config::copyEntityConfigs();
+    if (!EntityConfigLoader::loadFromFile(getConfigPath(), reloaded)) {
+        return false;
+    }
+
+    // The atlas is packed once at startup
+    for (size_t type = 0; type < ENTITY_TYPE_COUNT; type++) {
+        const std::optional<EntityConfig> &config = reloaded[type];
+        if (config.has_value() && config->visual.has_value() && !config->visual->filename.empty() &&
+            !TextureAtlas::getInstance().hasRegion(config->visual->filename)) {
+            std::cerr << "Sprite sheet " << config->visual->filename << " of "
+                      << EntityConfigLoader::getTypeName(static_cast<EntityType>(type))
+                      << " is not in the atlas, restart to load it" << std::endl;
+        }
+    }
+
+    configs = std::move(reloaded);
+    loadEntityData();
+    return true;
+}
 
 void EntityManager::loadEntityData()
 {
-    for (const auto &[type, config] : Config::ENTITY_CONFIGS) {
-        EntityData &entity = entityData[type];
+    for (size_t type = 0; type < ENTITY_TYPE_COUNT; type++) {
+        entityData[type].reset();
+        if (!configs[type].has_value()) {
+            continue;
+        }
+        const EntityConfig &config = *configs[type];
+        EntityData &entity = entityData[type].emplace();
         if (config.visual.has_value())
             entity.addComponent<VisualComponent>(config.visual.value());
         if (config.collision.has_value())
@@ -25,5 +110,98 @@ void EntityManager::loadEntityData()
 
 const EntityData &EntityManager::getEntityData(EntityType type) const
 {
-    return entityData.at(type);
+    return entityData[toIndex(type)].value();
+}
+
+void EntityManager::spawnMany(Game *pGame, EntityType type, const sf::Vector2f *positions,
+                              size_t count, std::vector<std::unique_ptr<Entity>> &out,
+                              const sf::Vector2f *velocities, const float *health) const
+{
+    // Everything that depends on the type only is looked up once for the wave
+    const EntityData &prototype = getEntityData(type);
+    const EntityConfig &config = getConfig(type);
+    const auto *kinematicsData = prototype.getComponent<KinematicsComponent>();
+    const auto *collisionData = prototype.getComponent<CollisionComponent>();
+    const auto *visualData = prototype.getComponent<VisualComponent>();
+    const AnimationSet *animations = AnimationLibrary::getInstance().getSet(type);
+
+    sf::Vector2f baseScale{1.f, 1.f};
+    float rotation{0.f};
+    if (config.visual.has_value()) {
+        baseScale = config.visual->scale;
+        rotation = config.visual->rotation;
+    }
+
+    WavePool<TransformComponent> transforms(count);
+    std::optional<WavePool<KinematicsComponent>> kinematics;
+    std::optional<WavePool<CollisionComponent>> collisions;
+    std::optional<WavePool<VisualComponent>> visuals;
+    std::optional<WavePool<DirectionComponent>> directions;
+    std::optional<WavePool<AnimationComponent>> animationPool;
+    std::optional<WavePool<HealthComponent>> healthPool;
+    if (kinematicsData)
+        kinematics.emplace(count);
+    if (collisionData)
+        collisions.emplace(count);
+    if (visualData) {
+        visuals.emplace(count);
+        directions.emplace(count);
+    }
+    if (animations)
+        animationPool.emplace(count);
+    if (health)
+        healthPool.emplace(count);
+
+    out.reserve(out.size() + count);
+    for (size_t i = 0; i < count; i++) {
+        std::unique_ptr<Entity> entity(
+            new Entity(pGame, type, positions[i], Entity::NoComponents{}));
+
+        // Same components, in the same order, as Entity::initComponents
+        entity->adoptComponent(transforms.add(positions[i], rotation, baseScale));
+
+        if (kinematics) {
+            auto &component = entity->adoptComponent(kinematics->add(*kinematicsData));
+            component.baseScale = baseScale;
+            if (velocities)
+                component.velocity = velocities[i];
+        }
+
+        if (collisions)
+            entity->adoptComponent(collisions->add(*collisionData));
+
+        if (visuals) {
+            entity->adoptComponent(visuals->add(*visualData));
+            entity->adoptComponent(directions->add());
+        }
+
+        if (animationPool)
+            entity->adoptComponent(animationPool->add(*animations));
+
+        if (healthPool)
+            entity->adoptComponent(healthPool->add(health[i]));
+
+        out.push_back(std::move(entity));
+    }
+}
+
+const EntityConfig &EntityManager::getConfig(EntityType type) const
+{
+    return configs[toIndex(type)].value();
+}
+
+void EntityManager::setConfigPath(const std::string &path)
+{
+    configPath = path;
+    loadConfigs();
+}
+
+std::string EntityManager::getConfigPath() const
+{
+    return configPath.empty() ? ResourceManager::getFilePath("entities.cfg") : configPath;
+}
+
+std::string EntityManager::getBlobPath() const
+{
+    return std::filesystem::path(getConfigPath()).replace_extension(".bin").string();
 }
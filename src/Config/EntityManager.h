@@ -1,10 +1,16 @@
 #pragma once
 #include <SFML/Graphics.hpp>
-#include <unordered_map>
+#include <string>
+#include <array>
+#include <optional>
 
 #include "EntityData.h"
+#include "GameConfig.h"
 #include "../Types.h"
 
+class Entity;
+class Game;
+
 class EntityManager
 {
 public:
@@ -14,13 +20,39 @@ public:
         return instance;
     }
 
+    // Compiled-in definitions, overridden per type by the config file when it exists. A blob
+    // compiled from that exact file (getBlobPath) is mapped instead of parsing the text.
+    void loadConfigs();
+    // Reads the config file again, everything stays as it was if it fails to parse.
+    // Rebuilds the prototypes, live entities are patched by Entity::applyConfig.
+    bool reloadConfigs();
+    // Prototypes are built from the configs, needs the texture atlas
     void loadEntityData();
+
     const EntityData &getEntityData(EntityType type) const;
 
+    // Spawns count entities of one type from its prototype and appends them to out. Every
+    // component type gets one allocation for the whole wave instead of one per entity.
+    // velocities and health are optional arrays parallel to positions.
+    void spawnMany(Game *pGame, EntityType type, const sf::Vector2f *positions, size_t count,
+                   std::vector<std::unique_ptr<Entity>> &out,
+                   const sf::Vector2f *velocities = nullptr, const float *health = nullptr) const;
+    const EntityConfig &getConfig(EntityType type) const;
+    const EntityConfigTable &getConfigs() const { return configs; }
+
+    // Defaults to entities.cfg in the assets directory, call before Game::initialise
+    void setConfigPath(const std::string &path);
+    std::string getConfigPath() const;
+    // The config path with a .bin extension, written by survive_configc
+    std::string getBlobPath() const;
+
     EntityManager(const EntityManager &) = delete;
     EntityManager &operator=(const EntityManager &) = delete;
 
 private:
-    std::unordered_map<EntityType, EntityData> entityData;
-    EntityManager() { this->loadEntityData(); }
+    // Indexed by EntityType, a lookup is an array index
+    EntityConfigTable configs;
+    std::array<std::optional<EntityData>, ENTITY_TYPE_COUNT> entityData;
+    std::string configPath;
+    EntityManager() { this->loadConfigs(); }
 };
@@ -11,6 +11,7 @@ namespace Config {
                            .setFilename("soldier.png")
                            .setScale({2.f, 2.f})
                            .setOrigin({50.f, 50.f})
+                           .setYSort(true)
                            .build())
             .setKinematics(KinematicsDataBuilder()
                                .setVelocity({0.f, 0.f})
@@ -65,6 +66,7 @@ namespace Config {
                            .setFilename("waveform2.png")
                            .setScale({1.0f, 1.0f})
                            .setOrigin({0.f, 15.f})
+                           .setLayer(RenderLayer::Weapons)
                            .build())
             .setCollision(CollisionDataBuilder()
                               .setBox({95.f, 32.f})
@@ -101,6 +103,7 @@ namespace Config {
                            .setFilename("soldier.png")
                            .setScale({2.f, 2.f})
                            .setOrigin({50.f, 50.f})
+                           .setYSort(true)
                            .build())
             .setCollision(CollisionDataBuilder()
                               .setBox({40.f, 40.f})
@@ -131,6 +134,7 @@ namespace Config {
                            .setFilename("vampire.png")
                            .setScale({2.f, 2.f})
                            .setOrigin({8.f, 8.f})
+                           .setYSort(true)
                            .build())
             .setCollision(CollisionDataBuilder()
                               .setBox({16.f, 16.f})
@@ -193,13 +197,19 @@ namespace Config {
                                .build())
             .build();
 
-    const std::unordered_map<EntityType, const EntityConfig &> ENTITY_CONFIGS = {
-        {EntityType::PLAYER, PLAYER},
-        {EntityType::TOWER, TOWER},
-        {EntityType::LASER_WEAPON, LASER_WEAPON},
-        {EntityType::VAMPIRE, VAMPIRE},
-        {EntityType::TEST_BOX, TEST_BOX},
-        {EntityType::WALL_HORIZONTAL, WALL_HORIZONTAL},
-        {EntityType::WALL_VERTICAL, WALL_VERTICAL}}; // namespace Config
+    EntityConfigTable copyEntityConfigs()
+    {
+        EntityConfigTable table;
+        for (size_t type = 0; type < ENTITY_TYPE_COUNT; type++) {
+            if (ENTITY_CONFIGS[type]) {
+                table[type] = *ENTITY_CONFIGS[type];
+            }
+        }
+        return table;
+    }
+
+    const ParticleBurst HIT_SPARKS = {6, 150.f, 400.f, 50.f, 0.15f, 0.35f, 3.f, {255, 200, 80}};
+    const ParticleBurst IMPACT_DUST = {4, 20.f, 80.f, 120.f, 0.3f, 0.6f, 4.f, {180, 170, 150}};
+    const ParticleBurst EXPLOSION = {120, 50.f, 450.f, 360.f, 0.4f, 1.1f, 5.f, {255, 120, 40}};
 
 } // namespace Config
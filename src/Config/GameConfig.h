@@ -1,8 +1,13 @@
 #pragma once
 #include <SFML/Graphics.hpp>
-#include <unordered_map>
+#include <array>
 #include <optional>
 #include "../Types.h"
+#include "../FixedVector.h"
+
+// Most points a collision polygon can have, polygons are stored inline
+constexpr size_t MAX_POLYGON_POINTS = 16;
+using PolygonPoints = FixedVector<sf::Vector2f, MAX_POLYGON_POINTS>;
 
 // Kinematics behavior types (can be combined with bitwise OR)
 enum class KinematicsBehavior : uint32_t
@@ -52,6 +57,15 @@ struct CollisionResult
     float depth;
 };
 
+// Draw layers, lower layers are drawn first
+enum class RenderLayer : uint8_t
+{
+    Ground,
+    Characters,
+    Weapons,
+    Effects
+};
+
 // Data structures for component configurations
 struct VisualComponentData
 {
@@ -60,6 +74,8 @@ struct VisualComponentData
     sf::Vector2f origin;
     sf::Vector2f offset;
     float rotation;
+    RenderLayer layer;
+    bool ySort; // order by y position within the layer
 };
 
 struct CollisionComponentData
@@ -70,7 +86,7 @@ struct CollisionComponentData
     float radius;
 
     // For polygons:
-    std::vector<sf::Vector2f> points; // Local space points
+    PolygonPoints points; // Local space points
 
     // Transform data
     sf::Vector2f scale;
@@ -114,20 +130,63 @@ struct KinematicsComponentData
     bool isStatic;
 };
 
+// One emission of particles, e.g. the sparks of a single hit
+struct ParticleBurst
+{
+    size_t count;
+    float speedMin;
+    float speedMax;
+    float spread; // degrees around the emit direction, 360 for all around
+    float lifetimeMin;
+    float lifetimeMax;
+    float size;
+    sf::Color color;
+};
+
+// Animations indexed by EntityState, states without one are empty
+using AnimationTable = std::array<std::optional<AnimationInfo>, ENTITY_STATE_COUNT>;
+
 struct EntityConfig
 {
     std::optional<VisualComponentData> visual;
     std::optional<CollisionComponentData> collision;
-    std::unordered_map<EntityState, AnimationInfo> animations;
+    AnimationTable animations;
     std::optional<WeaponComponentData> weapon;
     std::optional<KinematicsComponentData> kinematics;
 };
 
+// Configs indexed by EntityType, types without a definition are empty
+using EntityConfigTable = std::array<std::optional<EntityConfig>, ENTITY_TYPE_COUNT>;
+
 namespace Config {
     extern const EntityConfig PLAYER;
     extern const EntityConfig TOWER;
     extern const EntityConfig LASER_WEAPON;
     extern const EntityConfig VAMPIRE;
     extern const EntityConfig TEST_BOX;
-    extern const std::unordered_map<EntityType, const EntityConfig &> ENTITY_CONFIGS;
+    extern const EntityConfig WALL_HORIZONTAL;
+    extern const EntityConfig WALL_VERTICAL;
+
+    // Compiled-in definition of each type, nullptr where there is none. Only addresses, so the
+    // table is constant initialised and a lookup is an index. Every slot is written through
+    // toIndex, so reordering EntityType cannot hand a type another type's config.
+    inline constexpr std::array<const EntityConfig *, ENTITY_TYPE_COUNT> ENTITY_CONFIGS = [] {
+        std::array<const EntityConfig *, ENTITY_TYPE_COUNT> configs{};
+        configs[toIndex(EntityType::PLAYER)] = &PLAYER;
+        configs[toIndex(EntityType::TOWER)] = &TOWER;
+        configs[toIndex(EntityType::LASER_WEAPON)] = &LASER_WEAPON;
+        configs[toIndex(EntityType::VAMPIRE)] = &VAMPIRE;
+        configs[toIndex(EntityType::TEST_BOX)] = &TEST_BOX;
+        configs[toIndex(EntityType::WALL_HORIZONTAL)] = &WALL_HORIZONTAL;
+        configs[toIndex(EntityType::WALL_VERTICAL)] = &WALL_VERTICAL;
+        return configs;
+    }();
+
+    // Copies of the compiled-in definitions, the base layer config files override
+    EntityConfigTable copyEntityConfigs();
+
+    // Particle effects
+    extern const ParticleBurst HIT_SPARKS;
+    extern const ParticleBurst IMPACT_DUST;
+    extern const ParticleBurst EXPLOSION;
 } // namespace Config
@@ -3,6 +3,7 @@
 namespace Constants {
     // Debug
     constexpr int DEBUG_DRAW = true;
+    constexpr const char *PROFILE_TRACE_FILE = "trace.json"; // written with F4 when profiling
     // Screen
     constexpr int SCREEN_WIDTH = 1600;
     constexpr int SCREEN_HEIGHT = 1200;
@@ -17,6 +18,13 @@ namespace Constants {
     constexpr float VAMPIRE_HEIGHT = 32.f;
     constexpr float VAMPIRE_WIDTH = 32.f;
     constexpr float VAMPIRE_SPEED = 100.f;
+    constexpr float VAMPIRE_HEALTH = 20.f;
+    constexpr int VAMPIRE_WAVE_SIZE = 1000;
+
+    // Particles
+    constexpr int PARTICLE_CAPACITY = 131072;
+    constexpr float PARTICLE_DRAG = 3.f;
+    constexpr float PARTICLE_IMPACT_SPEED = 150.f; // slower contacts don't kick up dust
 
     // Wall
     constexpr float WALL_THICKNESS = 500.f;
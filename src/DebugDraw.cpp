@@ -0,0 +1,88 @@
+#include "DebugDraw.h"
+#include "Constants.h"
+#include "MathUtils.h"
+#include <cmath>
+
+DebugDraw::DebugDraw()
+{
+    if (Constants::DEBUG_DRAW) {
+        m_layers = Colliders;
+    }
+}
+
+void DebugDraw::setEnabled(Layer layer, bool enabled)
+{
+    if (enabled)
+        m_layers |= layer;
+    else
+        m_layers &= ~static_cast<uint32_t>(layer);
+}
+
+void DebugDraw::addTriangle(const sf::Vector2f &a, const sf::Vector2f &b, const sf::Vector2f &c,
+                            const sf::Color &color)
+{
+    m_vertices.append(sf::Vertex(a, color));
+    m_vertices.append(sf::Vertex(b, color));
+    m_vertices.append(sf::Vertex(c, color));
+}
+
+void DebugDraw::addLine(const sf::Vector2f &a, const sf::Vector2f &b, const sf::Color &color,
+                        float thickness)
+{
+    sf::Vector2f direction = b - a;
+    float length = VecLength(direction);
+    if (length < EPSILON) {
+        return;
+    }
+    sf::Vector2f side = Perpendicular(direction / length) * (thickness * 0.5f);
+
+    addTriangle(a - side, b - side, b + side, color);
+    addTriangle(a - side, b + side, a + side, color);
+}
+
+void DebugDraw::addPolygon(const sf::Vector2f *points, size_t count, const sf::Color &fill,
+                           const sf::Color &outline)
+{
+    if (count < 2) {
+        return;
+    }
+
+    sf::Vector2f centroid(0.f, 0.f);
+    for (size_t i = 0; i < count; i++) {
+        centroid += points[i];
+    }
+    centroid = centroid / static_cast<float>(count);
+
+    for (size_t i = 0; i < count; i++) {
+        const sf::Vector2f &a = points[i];
+        const sf::Vector2f &b = points[(i + 1) % count];
+        if (fill.a > 0) {
+            addTriangle(centroid, a, b, fill);
+        }
+        addLine(a, b, outline);
+    }
+}
+
+void DebugDraw::addCircle(const sf::Vector2f &center, float radius, const sf::Color &fill,
+                          const sf::Color &outline)
+{
+    sf::Vector2f points[CIRCLE_SEGMENTS];
+    for (size_t i = 0; i < CIRCLE_SEGMENTS; i++) {
+        float angle = 2.f * PI * i / CIRCLE_SEGMENTS;
+        points[i] = center + sf::Vector2f(std::cos(angle), std::sin(angle)) * radius;
+    }
+    addPolygon(points, CIRCLE_SEGMENTS, fill, outline);
+}
+
+void DebugDraw::addRect(const sf::FloatRect &rect, const sf::Color &outline)
+{
+    sf::Vector2f topLeft(rect.left, rect.top);
+    sf::Vector2f topRight(rect.left + rect.width, rect.top);
+    sf::Vector2f bottomRight(rect.left + rect.width, rect.top + rect.height);
+    sf::Vector2f bottomLeft(rect.left, rect.top + rect.height);
+
+    addLine(topLeft, topRight, outline);
+    addLine(topRight, bottomRight, outline);
+    addLine(bottomRight, bottomLeft, outline);
+    addLine(bottomLeft, topLeft, outline);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+
+// Streaming debug geometry, rebuilt every tick and drawn with a single draw call.
+// Everything is emitted as world space triangles, lines become 1px wide quads.
+class DebugDraw
+{
+public:
+    enum Layer : uint32_t
+    {
+        Colliders = 1 << 0,
+        ContactNormals = 1 << 1,
+        BroadphaseCells = 1 << 2,
+    };
+
+    DebugDraw();
+    ~DebugDraw() = default;
+
+    void clear() { m_vertices.clear(); }
+
+    bool isEnabled(Layer layer) const { return (m_layers & layer) != 0; }
+    bool isAnyEnabled() const { return m_layers != 0; }
+    void setEnabled(Layer layer, bool enabled);
+    void toggle(Layer layer) { m_layers ^= layer; }
+
+    void addLine(const sf::Vector2f &a, const sf::Vector2f &b, const sf::Color &color,
+                 float thickness = 1.f);
+    // Filled from the centroid, so mildly concave outlines like the player's still look right
+    void addPolygon(const sf::Vector2f *points, size_t count, const sf::Color &fill,
+                    const sf::Color &outline);
+    void addCircle(const sf::Vector2f &center, float radius, const sf::Color &fill,
+                   const sf::Color &outline);
+    void addRect(const sf::FloatRect &rect, const sf::Color &outline);
+
+    const sf::VertexArray &getVertices() const { return m_vertices; }
+
+    static constexpr size_t CIRCLE_SEGMENTS = 24;
+
+private:
+    void addTriangle(const sf::Vector2f &a, const sf::Vector2f &b, const sf::Vector2f &c,
+                     const sf::Color &color);
+
+    sf::VertexArray m_vertices{sf::Triangles};
+    uint32_t m_layers{0};
+};
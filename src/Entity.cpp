@@ -1,10 +1,12 @@
 #include "Entity.h"
 #include "Game.h"
 #include "Config/EntityManager.h"
+#include "Config/AnimationLibrary.h"
 // NEW INCLUDES
 #include "Components/TransformComponent.h"
 #include "Components/KinematicsComponent.h"
 #include "Components/CollisionComponent.h"
+#include "Components/WeaponComponent.h"
 // OLD INCLUDES (for refactoring)
 #include "Components/AnimationComponent.h"
 #include "Components/DirectionComponent.h"
@@ -21,10 +23,19 @@ Entity::Entity(Game *pGame, EntityType type, const sf::Vector2f &position)
     initComponents();
 }
 
+Entity::Entity(Game *pGame, EntityType type, const sf::Vector2f &position, NoComponents)
+    : m_pGame(pGame)
+    , m_type(type)
+    , m_initialPosition(position)
+{
+    // Room for the usual set, so adopting them does not rehash
+    components.reserve(8);
+}
+
 void Entity::initComponents()
 {
     const EntityData &entityData = EntityManager::getInstance().getEntityData(m_type);
-    const EntityConfig &config = Config::ENTITY_CONFIGS.at(m_type);
+    const EntityConfig &config = EntityManager::getInstance().getConfig(m_type);
 
     sf::Vector2f baseScale{1, 1};
     float rotation{0.f};
@@ -49,16 +60,40 @@ void Entity::initComponents()
         addComponent<DirectionComponent>();
     }
 
-    if (!config.animations.empty()) {
-        auto &animComponent = addComponent<AnimationComponent>();
-        for (const auto &[state, animInfo] : config.animations) {
-            animComponent.addAnimation(state, animInfo);
-        }
+    if (const AnimationSet *animations = AnimationLibrary::getInstance().getSet(m_type)) {
+        addComponent<AnimationComponent>(*animations);
     }
 
     // add others later
 }
 
+void Entity::applyConfig()
+{
+    const EntityConfig &config = EntityManager::getInstance().getConfig(m_type);
+
+    auto *visual = getComponent<VisualComponent>();
+    if (visual && config.visual.has_value())
+        visual->applyConfig(config.visual.value());
+
+    auto *collision = getComponent<CollisionComponent>();
+    if (collision && config.collision.has_value())
+        collision->applyConfig(config.collision.value());
+
+    auto *kinematics = getComponent<KinematicsComponent>();
+    if (kinematics && config.kinematics.has_value())
+        kinematics->applyConfig(config.kinematics.value());
+
+    auto *weapon = getComponent<WeaponComponent>();
+    if (weapon && config.weapon.has_value())
+        weapon->applyConfig(config.weapon.value());
+
+    // The animation library has been rebuilt, clips start over
+    if (auto *anim = getComponent<AnimationComponent>()) {
+        if (anim->set->defaultState != EntityState::NOTHING)
+            anim->restart();
+    }
+}
+
 void Entity::draw(sf::RenderTarget &target, sf::RenderStates states) const {}
 
 sf::Vector2f Entity::getPosition() const
@@ -33,7 +33,18 @@ public:
     void applyCollisionImpulse(const sf::Vector2f &velocityChange);
     virtual void handleInput(float deltaTime, const InputState &input);
 
+    // Patches the components this entity already has from the current EntityManager config
+    void applyConfig();
+
 protected:
+    friend class EntityManager;
+
+    // For EntityManager::spawnMany, which hands the components in itself
+    struct NoComponents
+    {
+    };
+    Entity(Game *pGame, EntityType type, const sf::Vector2f &position, NoComponents);
+
     virtual void initComponents();
 
     Game *m_pGame;
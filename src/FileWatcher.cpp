@@ -0,0 +1,110 @@
+#include "FileWatcher.h"
+
+#include <iostream>
+#include <system_error>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+FileWatcher::~FileWatcher()
+{
+    stop();
+}
+
+bool FileWatcher::watch(const std::string &path)
+{
+    stop();
+
+    std::filesystem::path filePath(path);
+    std::error_code error;
+    m_path = path;
+    m_fileName = filePath.filename().string();
+    m_lastWriteTime = std::filesystem::last_write_time(filePath, error);
+    m_lastCheck = std::chrono::steady_clock::now();
+
+#ifdef __linux__
+    std::string directory = filePath.has_parent_path() ? filePath.parent_path().string() : ".";
+    m_notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_notifyFd >= 0) {
+        m_watchDescriptor = inotify_add_watch(m_notifyFd, directory.c_str(),
+                                              IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (m_watchDescriptor < 0) {
+            close(m_notifyFd);
+            m_notifyFd = -1;
+        }
+    }
+    if (m_notifyFd < 0) {
+        std::cerr << "inotify unavailable for " << directory << ", polling " << m_fileName
+                  << " instead" << std::endl;
+    }
+#endif
+
+    return true;
+}
+
+void FileWatcher::stop()
+{
+#ifdef __linux__
+    if (m_notifyFd >= 0) {
+        if (m_watchDescriptor >= 0) {
+            inotify_rm_watch(m_notifyFd, m_watchDescriptor);
+        }
+        close(m_notifyFd);
+    }
+#endif
+    m_notifyFd = -1;
+    m_watchDescriptor = -1;
+    m_path.clear();
+    m_fileName.clear();
+}
+
+bool FileWatcher::poll()
+{
+    if (!isWatching()) {
+        return false;
+    }
+    return m_notifyFd >= 0 ? pollNotifications() : pollModificationTime();
+}
+
+bool FileWatcher::pollNotifications()
+{
+    bool changed = false;
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+        ssize_t length = read(m_notifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN: drained
+            break;
+        }
+        for (char *cursor = buffer; cursor < buffer + length;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(cursor);
+            if (event->len > 0 && m_fileName == event->name) {
+                changed = true;
+            }
+            cursor += sizeof(inotify_event) + event->len;
+        }
+    }
+#endif
+    return changed;
+}
+
+bool FileWatcher::pollModificationTime()
+{
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_lastCheck < POLL_INTERVAL) {
+        return false;
+    }
+    m_lastCheck = now;
+
+    std::error_code error;
+    auto writeTime = std::filesystem::last_write_time(m_path, error);
+    if (error || writeTime == m_lastWriteTime) {
+        return false;
+    }
+    m_lastWriteTime = writeTime;
+    return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+// Reports when a file has been written. Uses inotify on Linux, watching the parent directory
+// so editors that save by renaming a temporary file are caught too. Elsewhere, or when inotify
+// is unavailable, falls back to comparing the modification time a few times a second.
+class FileWatcher
+{
+public:
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    bool watch(const std::string &path);
+    void stop();
+
+    // Non-blocking, true once per batch of changes since the last call
+    bool poll();
+
+    const std::string &getPath() const { return m_path; }
+    bool isWatching() const { return !m_path.empty(); }
+    bool isUsingNotifications() const { return m_notifyFd >= 0; }
+
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{250};
+
+private:
+    bool pollNotifications();
+    bool pollModificationTime();
+
+    std::string m_path;
+    std::string m_fileName;
+    int m_notifyFd{-1};
+    int m_watchDescriptor{-1};
+
+    std::filesystem::file_time_type m_lastWriteTime{};
+    std::chrono::steady_clock::time_point m_lastCheck{};
+};
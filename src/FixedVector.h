@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+
+// Vector with its storage inline and a hard capacity, for small lists that are copied around a
+// lot (collider polygons) and should never touch the heap
+template <typename T, size_t Capacity>
+class FixedVector
+{
+public:
+    FixedVector() = default;
+    FixedVector(std::initializer_list<T> items)
+    {
+        assert(items.size() <= Capacity);
+        for (const T &item : items) {
+            push_back(item);
+        }
+    }
+
+    // Returns false and drops the item when full
+    bool push_back(const T &item)
+    {
+        if (m_size == Capacity) {
+            return false;
+        }
+        m_items[m_size++] = item;
+        return true;
+    }
+
+    void clear() { m_size = 0; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    static constexpr size_t capacity() { return Capacity; }
+
+    T &operator[](size_t index) { return m_items[index]; }
+    const T &operator[](size_t index) const { return m_items[index]; }
+
+    T *data() { return m_items.data(); }
+    const T *data() const { return m_items.data(); }
+    T *begin() { return m_items.data(); }
+    T *end() { return m_items.data() + m_size; }
+    const T *begin() const { return m_items.data(); }
+    const T *end() const { return m_items.data() + m_size; }
+
+private:
+    std::array<T, Capacity> m_items{};
+    size_t m_size{0};
+};
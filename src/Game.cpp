@@ -2,33 +2,111 @@
 
 #include <SFML/Graphics.hpp>
 #include <SFML/System.hpp>
+#include <chrono>
 #include <iostream>
 #include <random>
 
+#include "AssetPreloader.h"
+#include "PerfCounters.h"
+#include "Profiler.h"
 #include "ResourceManager.h"
+#include "TextureAtlas.h"
 #include "Entity.h"
+#include "Config/EntityManager.h"
+#include "Config/AnimationLibrary.h"
+#include "Config/EntityConfigLoader.h"
 #include "Components/TransformComponent.h"
 #include "Components/CollisionComponent.h"
 #include "Components/KinematicsComponent.h"
 #include "Components/HealthComponent.h"
 #include "Components/WeaponComponent.h"
 #include "Components/OwnerComponent.h"
+#include "Components/VisualComponent.h"
+#include "Components/DirectionComponent.h"
+#include "Components/AnimationComponent.h"
 #include "Constants.h"
 
 Game::Game()
     : m_state(GameState::ACTIVE)
     , m_pClock(std::make_unique<sf::Clock>())
     , m_pPlayerEntity(nullptr)
-{}
+{
+    setSeed(std::random_device{}());
+}
 
 Game::~Game() {}
 
-bool Game::initialise()
+void Game::setSeed(uint32_t seed)
 {
-    if (!m_font.loadFromFile(ResourceManager::getFilePath("Lavigne.ttf"))) {
-        std::cerr << "Unable to load font" << std::endl;
+    m_random.setSeed(seed);
+    m_spawnRandom = m_random.getStream(RandomService::Spawn);
+    if (m_particleSystem) {
+        m_particleSystem->setRandom(m_random.getStream(RandomService::Particles));
+    }
+}
+
+bool Game::startRecording()
+{
+    if (m_tick > 0) {
+        std::cerr << "Recording has to start before the first tick" << std::endl;
         return false;
     }
+    m_recording = std::make_unique<InputRecording>(getSeed());
+    return true;
+}
+
+bool Game::initialise(bool headless)
+{
+    // Every asset startup needs is decoded in parallel, only the texture upload stays here
+    auto start = std::chrono::steady_clock::now();
+    AssetManifest manifest =
+        AssetManifest::fromConfigs(EntityManager::getInstance().getConfigs());
+    if (!headless) {
+        manifest.addFont("Lavigne.ttf");
+    }
+    AssetPreloader preloader;
+    preloader.start(manifest);
+    preloader.wait();
+
+    for (const LoadedAsset &asset : preloader.getAssets()) {
+        if (asset.entry.kind != AssetEntry::Kind::Font) {
+            continue;
+        }
+        if (!asset.loaded) {
+            std::cerr << "Unable to load font" << std::endl;
+            return false;
+        }
+        m_font = asset.font;
+    }
+    if (!headless) {
+        m_overlay = std::make_unique<PerformanceOverlay>(m_font);
+    }
+
+    // Pack every sprite sheet into the shared atlas before the first entity needs it.
+    // Headless games still need the regions, just not the textures.
+    auto packStart = std::chrono::steady_clock::now();
+    TextureAtlas::getInstance().build(preloader.getAssets());
+    auto uploadStart = std::chrono::steady_clock::now();
+    if (!headless && !TextureAtlas::getInstance().upload()) {
+        std::cerr << "Unable to upload texture atlas" << std::endl;
+        return false;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double, std::milli> pack = uploadStart - packStart;
+    std::chrono::duration<double, std::milli> upload = end - uploadStart;
+    std::chrono::duration<double, std::milli> total = end - start;
+    std::cout << "Startup assets:\n";
+    preloader.printReport(std::cout);
+    std::cout << "  atlas packed in " << pack.count() << " ms, uploaded in " << upload.count()
+              << " ms, " << total.count() << " ms in total" << std::endl;
+
+    // Prototypes point into the atlas, so they are built after it
+    EntityManager::getInstance().loadEntityData();
+    // Only live games hot reload, a replay or benchmark must not change under an edit
+    if (!headless) {
+        m_configWatcher.watch(EntityManager::getInstance().getConfigPath());
+    }
 
     // init systems
     m_collisionSystem = std::make_unique<CollisionSystem>();
@@ -36,6 +114,13 @@ bool Game::initialise()
     m_renderSystem = std::make_unique<RenderSystem>();
     m_animationSystem = std::make_unique<AnimationSystem>();
     m_targetingSystem = std::make_unique<TargetingSystem>();
+    m_particleSystem = std::make_unique<ParticleSystem>();
+    m_particleSystem->setRandom(m_random.getStream(RandomService::Particles));
+
+    m_collisionSystem->setDebugDraw(&m_debugDraw);
+    m_renderSystem->setDebugDraw(&m_debugDraw);
+    m_renderSystem->setParticleSystem(m_particleSystem.get());
+    scheduleSystems();
 
     // Create a player controlled box
     auto playerEntity =
@@ -104,17 +189,46 @@ void Game::createBoundaryWalls()
 
 void Game::update(float deltaTime, sf::RenderWindow &window)
 {
+    WindowInputSource input(window);
+    update(deltaTime, input);
+}
+
+void Game::update(float deltaTime, InputSource &source)
+{
+    PROFILE_SCOPE("Game::update");
+    auto start = std::chrono::steady_clock::now();
+    const AllocCounts allocationsBefore = AllocTracker::getTotal();
+    const float frameDeltaTime = deltaTime;
+    const float frameMs = deltaTime * 1000.f;
+
     // Cap deltaTime
     deltaTime = std::min(deltaTime, 0.1f);
 
+    // Config edits are applied between ticks
+    if (m_configWatcher.poll()) {
+        reloadConfig();
+    }
+
     switch (m_state) {
     case GameState::ACTIVE: {
+        {
+            PROFILE_SCOPE("Game::input");
+            source.update(m_inputHandler);
+        }
         InputState &input = m_inputHandler.getState();
+        if (m_recording) {
+            m_recording->add(frameDeltaTime, input);
+        }
+        m_debugDraw.clear();
 
         if (input.spawnBox) {
             spawnBox();
             input.spawnBox = false;
         }
+        if (input.spawnWave) {
+            spawnVampireWave();
+            input.spawnWave = false;
+        }
         if (input.action1) {
             auto weapon = std::make_unique<Entity>(this, EntityType::LASER_WEAPON,
                                                    m_pPlayerEntity->getPosition());
@@ -126,10 +240,6 @@ void Game::update(float deltaTime, sf::RenderWindow &window)
             input.action1 = false; // Consume the input
         }
 
-        sf::Vector2i pixelPos = sf::Mouse::getPosition(window);
-        sf::Vector2f worldPos = window.mapPixelToCoords(pixelPos);
-        input.mouseWorldPosition = worldPos;
-
         if (m_pPlayerEntity) {
             m_pPlayerEntity->handleInput(deltaTime, input);
             if (auto *kin = m_pPlayerEntity->getComponent<KinematicsComponent>()) {
@@ -137,26 +247,158 @@ void Game::update(float deltaTime, sf::RenderWindow &window)
             }
         }
 
-        // Run logic systems
-        m_targetingSystem->update(m_entities);
-        m_kinematicsSystem->update(deltaTime, m_entities);
-        m_collisionSystem->update(deltaTime, m_entities);
-        m_animationSystem->update(deltaTime, m_entities);
+        // Run logic systems, see scheduleSystems for the order
+        PROFILE_SCOPE("Game::systems");
+        m_scheduler.run(deltaTime, JobSystem::getInstance());
+        m_tick++;
     } break;
 
     case GameState::WAITING:
         break;
     }
+
+    m_lastUpdateAllocations = AllocTracker::getTotal() - allocationsBefore;
+
+    if (m_overlay) {
+        std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        m_overlay->update(getOverlayStats(frameMs, elapsed.count()));
+    }
 }
 
-void Game::draw(sf::RenderTarget &target, sf::RenderStates states) const
+OverlayStats Game::getOverlayStats(float frameMs, float updateMs) const
 {
+    return {frameMs, updateMs, m_lastUpdateAllocations, &m_scheduler, &m_entities,
+            m_collisionSystem->getCandidatePairCount(), m_collisionSystem->getEvents().size(),
+            m_particleSystem->getCount()};
+}
+
+void Game::reloadConfig()
+{
+    PROFILE_SCOPE("Game::reloadConfig");
+    auto start = std::chrono::steady_clock::now();
+    if (!EntityManager::getInstance().reloadConfigs()) {
+        std::cerr << "Keeping the previous entity definitions" << std::endl;
+        return;
+    }
+    AnimationLibrary::getInstance().rebuild();
+
+    for (auto &entity : m_entities) {
+        entity->applyConfig();
+    }
+    // Slots still point into the old frame array
+    m_animationSystem->resetClips();
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Reloaded " << EntityManager::getInstance().getConfigPath() << " in "
+              << elapsed.count() << " ms, " << m_entities.size() << " entities patched"
+              << std::endl;
+}
+
+void Game::scheduleSystems()
+{
+    // Added in the old serial order, which the scheduler keeps wherever two systems conflict.
+    // Animation only touches its own components, so it runs next to the movement chain.
+    m_scheduler.addSystem("targeting",
+                          SystemAccess()
+                              .read<OwnerComponent>()
+                              .read<TransformComponent>()
+                              .write<KinematicsComponent>(),
+                          [this](float) { m_targetingSystem->update(m_entities); });
+
+    m_scheduler.addSystem("kinematics",
+                          SystemAccess()
+                              .read<OwnerComponent>()
+                              .write<KinematicsComponent>()
+                              .write<TransformComponent>()
+                              .write<DirectionComponent>(),
+                          [this](float dt) { m_kinematicsSystem->update(dt, m_entities); });
+
+    m_scheduler.addSystem("collision",
+                          SystemAccess()
+                              .read<OwnerComponent>()
+                              .write<CollisionComponent>()
+                              .write<TransformComponent>()
+                              .write<KinematicsComponent>()
+                              .write<HealthComponent>()
+                              .write<WeaponComponent>()
+                              .write<CollisionSystem>() // its events
+                              .write<DebugDraw>(),
+                          [this](float dt) { m_collisionSystem->update(dt, m_entities); });
+
+    m_scheduler.addSystem("particles",
+                          SystemAccess().read<CollisionSystem>().write<ParticleSystem>(),
+                          [this](float dt) {
+                              emitCollisionEffects();
+                              m_particleSystem->update(dt);
+                          });
+
+    m_scheduler.addSystem("animation",
+                          SystemAccess().write<AnimationComponent>().write<VisualComponent>(),
+                          [this](float dt) { m_animationSystem->update(dt, m_entities); });
+}
 
+void Game::emitCollisionEffects()
+{
+    for (const auto &event : m_collisionSystem->getEvents()) {
+        switch (event.type) {
+        case CollisionEvent::Hit:
+            m_particleSystem->emit(event.point, -event.normal, Config::HIT_SPARKS);
+            break;
+        case CollisionEvent::Kill:
+            m_particleSystem->emit(event.point, event.normal, Config::EXPLOSION);
+            break;
+        case CollisionEvent::Contact:
+            if (event.speed > Constants::PARTICLE_IMPACT_SPEED) {
+                m_particleSystem->emit(event.point, -event.normal, Config::IMPACT_DUST);
+            }
+            break;
+        }
+    }
+}
+
+void Game::draw(sf::RenderTarget &target, sf::RenderStates states) const
+{
     m_renderSystem->draw(target, states, m_entities);
+    if (m_overlay) {
+        m_overlay->draw(target, m_overlay->getFrame());
+    }
+}
+
+void Game::buildSnapshot(const sf::View &view, RenderSnapshot &snapshot) const
+{
+    m_renderSystem->buildSnapshot(view, m_entities, snapshot);
+    if (m_overlay) {
+        snapshot.overlay = m_overlay->getFrame();
+    }
+    snapshot.tick = m_tick;
+}
+
+void Game::drawSnapshot(sf::RenderTarget &target, const RenderSnapshot &snapshot) const
+{
+    m_renderSystem->drawSnapshot(target, sf::RenderStates::Default, snapshot);
+    if (m_overlay) {
+        m_overlay->draw(target, snapshot.overlay);
+    }
 }
 
 void Game::onKeyPressed(sf::Keyboard::Key key)
 {
+    // Debug draw toggles
+    if (key == sf::Keyboard::F1)
+        m_debugDraw.toggle(DebugDraw::Colliders);
+    else if (key == sf::Keyboard::F2)
+        m_debugDraw.toggle(DebugDraw::ContactNormals);
+    else if (key == sf::Keyboard::F3)
+        m_debugDraw.toggle(DebugDraw::BroadphaseCells);
+    else if (key == sf::Keyboard::F5 && m_overlay)
+        m_overlay->toggle();
+    else if (key == sf::Keyboard::F6)
+        PerfCounters::getInstance().setEnabled(!PerfCounters::getInstance().isEnabled());
+#ifdef SURVIVE_PROFILING
+    else if (key == sf::Keyboard::F4)
+        Profiler::getInstance().writeChromeTrace(Constants::PROFILE_TRACE_FILE);
+#endif
+
     m_inputHandler.onKeyPressed(key);
 }
 
@@ -175,14 +417,11 @@ void Game::spawnBox(const sf::Vector2f *position)
         spawnPos = *position;
     }
     else {
-        // Use random position
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<> width(0, Constants::SCREEN_WIDTH);
-        std::uniform_real_distribution<> height(0, Constants::SCREEN_HEIGHT);
-        std::uniform_real_distribution<> rdm(-100, 100);
-        spawnPos = sf::Vector2f(width(gen), height(gen));
-        rnd = sf::Vector2f(rdm(gen), rdm(gen));
+        // Use random position, drawn in a fixed order so replays match
+        spawnPos.x = m_spawnRandom.range(0.f, Constants::SCREEN_WIDTH);
+        spawnPos.y = m_spawnRandom.range(0.f, Constants::SCREEN_HEIGHT);
+        rnd.x = m_spawnRandom.range(-100.f, 100.f);
+        rnd.y = m_spawnRandom.range(-100.f, 100.f);
     }
 
     auto box = std::make_unique<Entity>(this, EntityType::TEST_BOX, spawnPos);
@@ -193,3 +432,30 @@ void Game::spawnBox(const sf::Vector2f *position)
     box->addComponent<HealthComponent>(10.f);
     m_entities.push_back(std::move(box));
 }
+
+double Game::spawnWave(EntityType type, const std::vector<sf::Vector2f> &positions,
+                       const std::vector<sf::Vector2f> &velocities,
+                       const std::vector<float> &health)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    const bool hasVelocities = velocities.size() == positions.size();
+    const bool hasHealth = health.size() == positions.size();
+    EntityManager::getInstance().spawnMany(this, type, positions.data(), positions.size(),
+                                           m_entities, hasVelocities ? velocities.data() : nullptr,
+                                           hasHealth ? health.data() : nullptr);
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Spawned " << positions.size() << " " << EntityConfigLoader::getTypeName(type)
+              << " in " << elapsed.count() << " ms" << std::endl;
+    return elapsed.count();
+}
+
+void Game::spawnVampireWave()
+{
+    std::vector<sf::Vector2f> positions(Constants::VAMPIRE_WAVE_SIZE);
+    m_spawnRandom.fill(positions.data(), positions.size(),
+                       sf::FloatRect(0.f, 0.f, Constants::SCREEN_WIDTH, Constants::SCREEN_HEIGHT));
+    std::vector<float> health(positions.size(), Constants::VAMPIRE_HEALTH);
+    spawnWave(EntityType::VAMPIRE, positions, {}, health);
+}
@@ -9,11 +9,19 @@
 #include "Constants.h"
 #include "Types.h"
 #include "InputHandler.h"
+#include "InputRecording.h"
+#include "InputSource.h"
 #include "Components/CollisionSystem.h"
 #include "Components/KinematicsSystem.h"
 #include "Components/AnimationSystem.h"
 #include "Components/TargetingSystem.h"
 #include "RenderSystem.h"
+#include "DebugDraw.h"
+#include "FileWatcher.h"
+#include "ParticleSystem.h"
+#include "PerformanceOverlay.h"
+#include "Random.h"
+#include "SystemScheduler.h"
 
 class Entity;
 class Game;
@@ -24,11 +32,38 @@ public:
     Game();
     ~Game();
 
-    bool initialise();
+    // Headless games skip everything that needs a GL context: the font and the atlas textures.
+    // They do not watch the entity config either, edits never reach a replay or benchmark.
+    bool initialise(bool headless = false);
+    void update(float deltaTime, InputSource &input);
     void update(float deltaTime, sf::RenderWindow &window);
     void draw(sf::RenderTarget &target, sf::RenderStates states) const override;
 
+    // Render thread mode: the simulation publishes snapshots that are drawn elsewhere
+    void buildSnapshot(const sf::View &view, RenderSnapshot &snapshot) const;
+    void drawSnapshot(sf::RenderTarget &target, const RenderSnapshot &snapshot) const;
+
     GameState getState() const { return m_state; }
+    uint64_t getTick() const { return m_tick; }
+    size_t getEntityCount() const { return m_entities.size(); }
+    const std::vector<std::unique_ptr<Entity>> &getEntities() const { return m_entities; }
+    const AnimationSystem &getAnimationSystem() const { return *m_animationSystem; }
+    SystemScheduler &getScheduler() { return m_scheduler; }
+    CollisionSystem &getCollisionSystem() { return *m_collisionSystem; }
+    // Heap allocations on any thread while the last update ran, see AllocTracker
+    const AllocCounts &getLastUpdateAllocations() const { return m_lastUpdateAllocations; }
+    // What the performance overlay shows for the last update
+    OverlayStats getOverlayStats(float frameMs, float updateMs) const;
+
+    // World seed every system's random stream is derived from, see RandomService. The default
+    // comes from std::random_device, replays set the recorded seed before the first update.
+    void setSeed(uint32_t seed);
+    uint32_t getSeed() const { return static_cast<uint32_t>(m_random.getSeed()); }
+    const RandomService &getRandom() const { return m_random; }
+    // Records the frame time and input of every tick from the first update on, see
+    // InputRecording. Fails once the game has ticked, the recording could not be replayed.
+    bool startRecording();
+    const InputRecording *getRecording() const { return m_recording.get(); }
 
     void onKeyPressed(sf::Keyboard::Key key);
     void onKeyReleased(sf::Keyboard::Key key);
@@ -36,18 +71,41 @@ public:
     Entity *getPlayerEntity() const { return m_pPlayerEntity; }
 
     void spawnBox(const sf::Vector2f *position = nullptr);
+    // Spawns the whole wave through EntityManager::spawnMany and returns how long it took in ms.
+    // velocities and health are optional, otherwise one entry per position.
+    double spawnWave(EntityType type, const std::vector<sf::Vector2f> &positions,
+                     const std::vector<sf::Vector2f> &velocities = {},
+                     const std::vector<float> &health = {});
+    // Constants::VAMPIRE_WAVE_SIZE vampires at random positions
+    void spawnVampireWave();
     void createBoundaryWalls();
 
+    // Re-reads the entity definitions and patches every live entity, call it between ticks.
+    // Live games do so when the file changes.
+    void reloadConfig();
+
 private:
+    // Turns the collision events of the last update into hit sparks, dust and explosions
+    void emitCollisionEffects();
+    // Registers the per-tick systems with what each of them reads and writes
+    void scheduleSystems();
+
     std::vector<std::unique_ptr<Entity>> m_entities;
     Entity *m_pPlayerEntity;
 
     GameState m_state;
+    uint64_t m_tick{0};
+    AllocCounts m_lastUpdateAllocations;
     std::unique_ptr<sf::Clock> m_pClock;
+    RandomService m_random;
+    Random m_spawnRandom;
+    std::unique_ptr<InputRecording> m_recording;
 
     sf::Font m_font;
 
     InputHandler m_inputHandler;
+    DebugDraw m_debugDraw;
+    FileWatcher m_configWatcher;
 
     // Systems
     std::unique_ptr<CollisionSystem> m_collisionSystem;
@@ -55,4 +113,9 @@ private:
     std::unique_ptr<RenderSystem> m_renderSystem;
     std::unique_ptr<AnimationSystem> m_animationSystem;
     std::unique_ptr<TargetingSystem> m_targetingSystem;
+    std::unique_ptr<ParticleSystem> m_particleSystem;
+    SystemScheduler m_scheduler;
+
+    // Only with a window, it draws with m_font
+    std::unique_ptr<PerformanceOverlay> m_overlay;
 };
@@ -21,6 +21,9 @@ void InputHandler::onKeyPressed(sf::Keyboard::Key key)
     else if (key == sf::Keyboard::B) {
             m_state.spawnBox = true;
     }
+    else if (key == sf::Keyboard::V) {
+        m_state.spawnWave = true;
+    }
 }
 
 void InputHandler::onKeyReleased(sf::Keyboard::Key key)
@@ -43,4 +46,7 @@ void InputHandler::onKeyReleased(sf::Keyboard::Key key)
     else if (key == sf::Keyboard::B) {
         m_state.spawnBox = false;
     }
+    else if (key == sf::Keyboard::V) {
+        m_state.spawnWave = false;
+    }
 }
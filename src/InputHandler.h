@@ -15,6 +15,7 @@ struct InputState
     bool action1 = false;
     bool action1Released = true;
     bool spawnBox = false;
+    bool spawnWave = false;
 
     // Mouse
     sf::Vector2f mouseWorldPosition{0.f, 0.f};
@@ -0,0 +1,94 @@
+#include "InputRecording.h"
+#include "MappedFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+void InputRecording::add(float deltaTime, const InputState &state)
+{
+    Frame frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.deltaTime = deltaTime;
+    frame.mouseWorldPosition[0] = state.mouseWorldPosition.x;
+    frame.mouseWorldPosition[1] = state.mouseWorldPosition.y;
+    frame.flags = static_cast<uint8_t>(
+        (state.moveUp ? MoveUp : 0) | (state.moveDown ? MoveDown : 0) |
+        (state.moveLeft ? MoveLeft : 0) | (state.moveRight ? MoveRight : 0) |
+        (state.action1 ? Action1 : 0) | (state.action1Released ? Action1Released : 0) |
+        (state.spawnBox ? SpawnBox : 0) | (state.spawnWave ? SpawnWave : 0));
+    m_frames.push_back(frame);
+}
+
+InputState InputRecording::getState(size_t frame) const
+{
+    const Frame &record = m_frames[frame];
+    InputState state;
+    state.moveUp = record.flags & MoveUp;
+    state.moveDown = record.flags & MoveDown;
+    state.moveLeft = record.flags & MoveLeft;
+    state.moveRight = record.flags & MoveRight;
+    state.action1 = record.flags & Action1;
+    state.action1Released = record.flags & Action1Released;
+    state.spawnBox = record.flags & SpawnBox;
+    state.spawnWave = record.flags & SpawnWave;
+    state.mouseWorldPosition = {record.mouseWorldPosition[0], record.mouseWorldPosition[1]};
+    return state;
+}
+
+bool InputRecording::write(const std::string &path) const
+{
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.endianCheck = ENDIAN_CHECK;
+    header.seed = m_seed;
+    header.frameCount = m_frames.size();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(m_frames.data()), m_frames.size() * sizeof(Frame));
+    if (!file) {
+        std::cerr << "Unable to write input recording " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool InputRecording::read(const std::string &path)
+{
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+
+    auto reject = [&path](const char *reason) {
+        std::cerr << "Unable to read input recording " << path << ": " << reason << std::endl;
+        return false;
+    };
+
+    if (file.size() < sizeof(Header)) {
+        return reject("truncated");
+    }
+    Header header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.magic != MAGIC) {
+        return reject("not an input recording");
+    }
+    if (header.endianCheck != ENDIAN_CHECK) {
+        return reject("written on a machine with a different byte order");
+    }
+    if (header.version != VERSION) {
+        return reject("version mismatch");
+    }
+    if (header.frameCount != (file.size() - sizeof(Header)) / sizeof(Frame) ||
+        (file.size() - sizeof(Header)) % sizeof(Frame) != 0) {
+        return reject("frame count does not match the file size");
+    }
+
+    m_seed = header.seed;
+    m_frames.resize(header.frameCount);
+    std::memcpy(m_frames.data(), file.data() + sizeof(Header), m_frames.size() * sizeof(Frame));
+    return true;
+}
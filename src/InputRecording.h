@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "InputHandler.h"
+
+// Every tick of a session's input plus the seed the game ran with, so a session played with a
+// window can be run again headless and end up in the same state. Each tick keeps the frame time
+// Game::update was called with and the InputState once the input source has updated it.
+//
+//   Header | Frame records
+class InputRecording
+{
+public:
+    static constexpr uint32_t MAGIC = 0x52495653; // "SVIR"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t ENDIAN_CHECK = 0x01020304;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t endianCheck;
+        uint32_t seed;
+        uint64_t frameCount;
+    };
+
+    enum FrameFlags : uint8_t
+    {
+        MoveUp = 1 << 0,
+        MoveDown = 1 << 1,
+        MoveLeft = 1 << 2,
+        MoveRight = 1 << 3,
+        Action1 = 1 << 4,
+        Action1Released = 1 << 5,
+        SpawnBox = 1 << 6,
+        SpawnWave = 1 << 7,
+    };
+
+    // 16 bytes per tick, about 140 KB for a minute at 144 Hz
+    struct Frame
+    {
+        float deltaTime;
+        float mouseWorldPosition[2];
+        uint8_t flags;
+        uint8_t padding[3];
+    };
+
+    explicit InputRecording(uint32_t seed = 0)
+        : m_seed(seed)
+    {}
+
+    void add(float deltaTime, const InputState &state);
+
+    uint32_t getSeed() const { return m_seed; }
+    size_t getFrameCount() const { return m_frames.size(); }
+    float getDeltaTime(size_t frame) const { return m_frames[frame].deltaTime; }
+    InputState getState(size_t frame) const;
+
+    bool write(const std::string &path) const;
+    bool read(const std::string &path);
+
+private:
+    uint32_t m_seed;
+    std::vector<Frame> m_frames;
+};
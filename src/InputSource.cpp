@@ -0,0 +1,70 @@
+#include "InputSource.h"
+
+#include <SFML/Window/Mouse.hpp>
+#include <algorithm>
+
+void WindowInputSource::update(InputHandler &handler)
+{
+    sf::Vector2i pixelPos = sf::Mouse::getPosition(m_window);
+    handler.getState().mouseWorldPosition = m_window.mapPixelToCoords(pixelPos);
+}
+
+ScriptedInputSource::ScriptedInputSource(std::vector<Step> steps)
+    : m_steps(std::move(steps))
+{
+    std::stable_sort(m_steps.begin(), m_steps.end(),
+                     [](const Step &a, const Step &b) { return a.tick < b.tick; });
+}
+
+void ScriptedInputSource::press(uint64_t tick, sf::Keyboard::Key key)
+{
+    addStep({tick, Step::Press, key, {}});
+}
+
+void ScriptedInputSource::release(uint64_t tick, sf::Keyboard::Key key)
+{
+    addStep({tick, Step::Release, key, {}});
+}
+
+void ScriptedInputSource::moveMouse(uint64_t tick, const sf::Vector2f &worldPosition)
+{
+    addStep({tick, Step::Mouse, sf::Keyboard::Unknown, worldPosition});
+}
+
+void ScriptedInputSource::addStep(const Step &step)
+{
+    // Keep the list sorted, steps on the same tick stay in the order they were added
+    auto it = std::upper_bound(m_steps.begin() + m_next, m_steps.end(), step.tick,
+                               [](uint64_t tick, const Step &other) { return tick < other.tick; });
+    m_steps.insert(it, step);
+}
+
+void ScriptedInputSource::update(InputHandler &handler)
+{
+    // Steps for ticks that have already passed are skipped rather than replayed late
+    while (m_next < m_steps.size() && m_steps[m_next].tick <= m_tick) {
+        const Step &step = m_steps[m_next++];
+        if (step.tick < m_tick) {
+            continue;
+        }
+        switch (step.action) {
+        case Step::Press:
+            handler.onKeyPressed(step.key);
+            break;
+        case Step::Release:
+            handler.onKeyReleased(step.key);
+            break;
+        case Step::Mouse:
+            handler.getState().mouseWorldPosition = step.mouseWorldPosition;
+            break;
+        }
+    }
+    m_tick++;
+}
+
+void ReplayInputSource::update(InputHandler &handler)
+{
+    if (!isFinished()) {
+        handler.getState() = m_recording.getState(m_next++);
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Window/Keyboard.hpp>
+#include <cstdint>
+#include <vector>
+#include "InputHandler.h"
+#include "InputRecording.h"
+
+// Where the simulation gets its input from each tick. Game::update only talks to this, so the
+// same update path runs with a window, from a script, or from a recording.
+class InputSource
+{
+public:
+    virtual ~InputSource() = default;
+
+    // Called once at the start of every simulated tick, before the input state is read
+    virtual void update(InputHandler &handler) = 0;
+};
+
+// Live input: keys arrive through Game::onKeyPressed from the window's events, the mouse is
+// read here and mapped into world space with the window's view
+class WindowInputSource : public InputSource
+{
+public:
+    explicit WindowInputSource(const sf::RenderWindow &window)
+        : m_window(window)
+    {}
+
+    void update(InputHandler &handler) override;
+
+private:
+    const sf::RenderWindow &m_window;
+};
+
+// Replays a fixed list of key and mouse events keyed by tick, needs no window at all
+class ScriptedInputSource : public InputSource
+{
+public:
+    struct Step
+    {
+        enum Action
+        {
+            Press,
+            Release,
+            Mouse,
+        };
+
+        uint64_t tick;
+        Action action;
+        sf::Keyboard::Key key;
+        sf::Vector2f mouseWorldPosition;
+    };
+
+    ScriptedInputSource() = default;
+    explicit ScriptedInputSource(std::vector<Step> steps);
+
+    void press(uint64_t tick, sf::Keyboard::Key key);
+    void release(uint64_t tick, sf::Keyboard::Key key);
+    void moveMouse(uint64_t tick, const sf::Vector2f &worldPosition);
+
+    void update(InputHandler &handler) override;
+
+    uint64_t getTick() const { return m_tick; }
+    bool isFinished() const { return m_next >= m_steps.size(); }
+
+private:
+    void addStep(const Step &step);
+
+    std::vector<Step> m_steps; // sorted by tick, stable for steps on the same tick
+    size_t m_next{0};
+    uint64_t m_tick{0};
+};
+
+// Plays an InputRecording back, every tick gets the state exactly as it was recorded. The
+// caller passes getDeltaTime() to Game::update so the frame times match too.
+class ReplayInputSource : public InputSource
+{
+public:
+    explicit ReplayInputSource(const InputRecording &recording)
+        : m_recording(recording)
+    {}
+
+    void update(InputHandler &handler) override;
+
+    // Frame time of the next tick
+    float getDeltaTime() const { return m_recording.getDeltaTime(m_next); }
+    bool isFinished() const { return m_next >= m_recording.getFrameCount(); }
+
+private:
+    const InputRecording &m_recording;
+    size_t m_next{0};
+};
@@ -0,0 +1,185 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+
+namespace {
+    // Which pool the current thread works for and its queue in it. Threads that are not
+    // workers of a pool use queue 0, like the thread that created it.
+    thread_local const JobSystem *t_pool = nullptr;
+    thread_local size_t t_index = 0;
+} // namespace
+
+JobSystem::JobSystem(size_t threadCount)
+{
+    threadCount = std::max<size_t>(threadCount, 1);
+    m_queues.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+
+    m_workers.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; i++) {
+        m_workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (std::thread &worker : m_workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::run(Job job, JobCounter *counter)
+{
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    push({std::move(job), counter});
+}
+
+void JobSystem::runAfter(JobCounter &dependency, Job job, JobCounter *counter)
+{
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        // finish() takes the same lock after the count reaches zero, so a continuation added
+        // here is either seen by it or the dependency was already done
+        std::lock_guard<std::mutex> lock(dependency.m_mutex);
+        if (!dependency.isDone()) {
+            dependency.m_continuations.push_back({std::move(job), counter});
+            return;
+        }
+    }
+    push({std::move(job), counter});
+}
+
+void JobSystem::wait(JobCounter &counter)
+{
+    const size_t index = getThreadIndex();
+    Task task;
+    while (!counter.isDone()) {
+        if (pop(index, task) || steal(index, task)) {
+            execute(task);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    // Lets the thread that finished the last job release the counter, see finish()
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+void JobSystem::workerLoop(size_t index)
+{
+    t_pool = this;
+    t_index = index;
+    PROFILE_THREAD_NAME("worker " + std::to_string(index));
+
+    Task task;
+    while (true) {
+        if (pop(index, task) || steal(index, task)) {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this] { return m_stopping || m_queued.load() > 0; });
+        if (m_stopping && m_queued.load() == 0) {
+            return;
+        }
+    }
+}
+
+void JobSystem::push(Task task)
+{
+    Queue &queue = *m_queues[getThreadIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    // Counted before taking the sleep lock, so a worker checking the predicate cannot miss it
+    m_queued.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_wake.notify_one();
+}
+
+bool JobSystem::pop(size_t index, Task &task)
+{
+    Queue &queue = *m_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    // Newest first, its data is most likely still in cache
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    m_queued.fetch_sub(1);
+    return true;
+}
+
+bool JobSystem::steal(size_t index, Task &task)
+{
+    const size_t count = m_queues.size();
+    for (size_t offset = 1; offset < count; offset++) {
+        Queue &queue = *m_queues[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        // Oldest first, it is the one its owner would get to last
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        m_queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::execute(Task &task)
+{
+    task.job();
+    task.job = nullptr;
+    if (task.counter) {
+        finish(*task.counter);
+    }
+}
+
+void JobSystem::finish(JobCounter &counter)
+{
+    // Not the last job: nothing but the count is touched
+    uint32_t pending = counter.m_pending.load(std::memory_order_relaxed);
+    while (pending > 1) {
+        if (counter.m_pending.compare_exchange_weak(pending, pending - 1,
+                                                    std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+
+    // Possibly the last one. The count drops under the lock, and wait() takes the lock once it
+    // sees zero, so the counter cannot go away while this thread still uses it.
+    std::vector<JobCounter::Continuation> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter.m_mutex);
+        if (counter.m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            continuations.swap(counter.m_continuations);
+        }
+    }
+    for (auto &continuation : continuations) {
+        push({std::move(continuation.job), continuation.counter});
+    }
+}
+
+size_t JobSystem::getThreadIndex() const
+{
+    return t_pool == this ? t_index : 0;
+}
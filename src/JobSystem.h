@@ -0,0 +1,121 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Job = std::function<void()>;
+
+// Counts the jobs started against it that have not finished yet. Jobs queued with
+// JobSystem::runAfter start once it drops to zero. Wait on it with JobSystem::wait before it
+// goes out of scope.
+class JobCounter
+{
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator=(const JobCounter &) = delete;
+
+    bool isDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    struct Continuation
+    {
+        Job job;
+        JobCounter *counter;
+    };
+
+    std::atomic<uint32_t> m_pending{0};
+    std::mutex m_mutex;
+    std::vector<Continuation> m_continuations;
+};
+
+// Work-stealing thread pool. Every thread owns a queue: it pushes and pops its own jobs at the
+// back, and idle threads steal from the front of the others. The thread that created the pool
+// is thread 0 and only runs jobs while it waits, so a pool of one thread runs everything
+// inline in wait().
+class JobSystem
+{
+public:
+    // One thread per hardware thread
+    static JobSystem &getInstance()
+    {
+        static JobSystem instance(std::max(1u, std::thread::hardware_concurrency()));
+        return instance;
+    }
+
+    explicit JobSystem(size_t threadCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // Queues job on the calling thread's queue, counter (optional) is done once it has run
+    void run(Job job, JobCounter *counter = nullptr);
+    // Queues job once dependency is done, right away if it already is
+    void runAfter(JobCounter &dependency, Job job, JobCounter *counter = nullptr);
+    // Runs queued jobs, this thread's first, until counter is done
+    void wait(JobCounter &counter);
+
+    // Calls fn(first, last) on [begin, end) split into chunks of grain indices and returns once
+    // all of them ran. Small grains balance better, large ones cost less scheduling.
+    template <typename F> void parallelFor(size_t begin, size_t end, size_t grain, const F &fn)
+    {
+        grain = std::max<size_t>(grain, 1);
+        if (end <= begin) {
+            return;
+        }
+        if (end - begin <= grain || m_queues.size() == 1) {
+            fn(begin, end);
+            return;
+        }
+
+        JobCounter counter;
+        for (size_t first = begin; first < end; first += grain) {
+            const size_t last = std::min(first + grain, end);
+            run([&fn, first, last] { fn(first, last); }, &counter);
+        }
+        wait(counter);
+    }
+
+    size_t getThreadCount() const { return m_queues.size(); }
+
+private:
+    struct Task
+    {
+        Job job;
+        JobCounter *counter;
+    };
+
+    // Padded so neighbouring queues do not share a cache line
+    struct alignas(64) Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(size_t index);
+    void push(Task task);
+    bool pop(size_t index, Task &task);
+    bool steal(size_t index, Task &task);
+    void execute(Task &task);
+    void finish(JobCounter &counter);
+    size_t getThreadIndex() const;
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::atomic<size_t> m_queued{0};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    bool m_stopping{false};
+};
@@ -4,13 +4,29 @@
 #include "Game.h"
 #include <memory>
 #include <iostream>
+#include <cstring>
 
+#include "Profiler.h"
 #include "ResourceManager.h"
+#include "RenderThread.h"
+#include "Config/EntityManager.h"
 
 int main(int argc, char *argv[])
 {
     // ResourceManager Must be Instantiated here -- DO NOT CHANGE
     ResourceManager::init(argv[0]);
+    PROFILE_THREAD_NAME("main");
+
+    bool useRenderThread = false;
+    const char *recordPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--render-thread") == 0)
+            useRenderThread = true;
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (std::strcmp(argv[i], "--config") == 0 && i + 1 < argc)
+            EntityManager::getInstance().setConfigPath(argv[++i]);
+    }
 
     sf::RenderWindow window(sf::VideoMode(Constants::SCREEN_WIDTH, Constants::SCREEN_HEIGHT),
                             "Tower Defense");
@@ -22,16 +38,27 @@ int main(int argc, char *argv[])
         std::cerr << "Game Failed to initialise" << std::endl;
         return 1;
     }
+    // The whole session, written when the window closes, see survive_headless --replay
+    if (recordPath && !pGame->startRecording()) {
+        return 1;
+    }
+
+    // Draws on its own thread when enabled, the loop below then only simulates and publishes
+    RenderThread renderThread(window, *pGame);
+    if (useRenderThread)
+        renderThread.start();
 
     sf::Clock clock;
     // run the program as long as the window is open
     while (window.isOpen()) {
+        PROFILE_SCOPE("frame");
         // check all the window's events that were triggered since the last iteration of the loop
         sf::Event event;
         while (window.pollEvent(event)) {
             switch (event.type) {
             case sf::Event::Closed:
                 // "close requested" event: we close the window
+                renderThread.stop();
                 window.close();
                 break;
             case sf::Event::KeyPressed:
@@ -46,14 +73,24 @@ int main(int argc, char *argv[])
         }
         pGame->update(clock.restart().asSeconds(), window);
 
+        if (renderThread.isRunning()) {
+            pGame->buildSnapshot(window.getView(), renderThread.acquire());
+            renderThread.publish();
+            continue;
+        }
+
         // clear the window with black color
         window.clear(sf::Color::Black);
 
         window.draw(*pGame.get());
 
         // end the current frame
+        PROFILE_SCOPE("display");
         window.display();
     }
 
+    if (recordPath && !pGame->getRecording()->write(recordPath)) {
+        return 1;
+    }
     return 0;
 }
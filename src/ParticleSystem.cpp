@@ -0,0 +1,148 @@
+#include "ParticleSystem.h"
+#include "TextureAtlas.h"
+#include "MathUtils.h"
+
+#include <algorithm>
+#include <cmath>
+
+ParticleSystem::ParticleSystem(size_t capacity)
+    : m_capacity(capacity)
+{
+    // Allocate the whole pool up front, emitting never reallocates
+    m_positionX.resize(capacity);
+    m_positionY.resize(capacity);
+    m_velocityX.resize(capacity);
+    m_velocityY.resize(capacity);
+    m_life.resize(capacity);
+    m_invLifetime.resize(capacity);
+    m_size.resize(capacity);
+    m_color.resize(capacity);
+    m_frame.resize(capacity);
+
+    const AtlasRegion &white = TextureAtlas::getInstance().getWhiteRegion();
+    setFrames({white.rect}, static_cast<uint32_t>(white.page));
+}
+
+void ParticleSystem::setFrames(std::vector<sf::IntRect> frames, uint32_t page)
+{
+    if (frames.empty()) {
+        const AtlasRegion &white = TextureAtlas::getInstance().getWhiteRegion();
+        frames.push_back(white.rect);
+        page = static_cast<uint32_t>(white.page);
+    }
+    m_frames = std::move(frames);
+    m_page = page;
+}
+
+void ParticleSystem::emit(const sf::Vector2f &position, const sf::Vector2f &direction,
+                          const ParticleBurst &burst)
+{
+    const size_t count = std::min(burst.count, m_capacity - m_count);
+    m_dropped += burst.count - count;
+
+    const float baseAngle = std::atan2(direction.y, direction.x);
+    const float halfSpread = ToRadians(burst.spread) * 0.5f;
+    const uint32_t frameCount = static_cast<uint32_t>(m_frames.size());
+
+    for (size_t n = 0; n < count; n++) {
+        const size_t i = m_count++;
+        const float a = m_random.range(baseAngle - halfSpread, baseAngle + halfSpread);
+        const float v = m_random.range(burst.speedMin, burst.speedMax);
+        const float life = std::max(m_random.range(burst.lifetimeMin, burst.lifetimeMax), 0.001f);
+
+        m_positionX[i] = position.x;
+        m_positionY[i] = position.y;
+        m_velocityX[i] = std::cos(a) * v;
+        m_velocityY[i] = std::sin(a) * v;
+        m_life[i] = life;
+        m_invLifetime[i] = 1.f / life;
+        m_size[i] = burst.size;
+        m_color[i] = burst.color;
+        m_frame[i] = static_cast<uint16_t>(m_random.below(frameCount));
+    }
+}
+
+void ParticleSystem::update(float deltaTime)
+{
+    // Integration has no branches and no aliasing, so the compiler can vectorise it
+    const size_t count = m_count;
+    float *__restrict px = m_positionX.data();
+    float *__restrict py = m_positionY.data();
+    float *__restrict vx = m_velocityX.data();
+    float *__restrict vy = m_velocityY.data();
+    float *__restrict life = m_life.data();
+    const float damping = 1.f / (1.f + m_drag * deltaTime);
+
+    for (size_t i = 0; i < count; i++) {
+        vx[i] *= damping;
+        vy[i] *= damping;
+        px[i] += vx[i] * deltaTime;
+        py[i] += vy[i] * deltaTime;
+        life[i] -= deltaTime;
+    }
+
+    // Only the particles that died this step pay for the compaction
+    for (size_t i = 0; i < m_count;) {
+        if (m_life[i] > 0.f)
+            i++;
+        else
+            kill(i);
+    }
+}
+
+void ParticleSystem::kill(size_t index)
+{
+    const size_t last = --m_count;
+    m_positionX[index] = m_positionX[last];
+    m_positionY[index] = m_positionY[last];
+    m_velocityX[index] = m_velocityX[last];
+    m_velocityY[index] = m_velocityY[last];
+    m_life[index] = m_life[last];
+    m_invLifetime[index] = m_invLifetime[last];
+    m_size[index] = m_size[last];
+    m_color[index] = m_color[last];
+    m_frame[index] = m_frame[last];
+}
+
+void ParticleSystem::writeVertices(sf::VertexArray &vertices) const
+{
+    vertices.setPrimitiveType(sf::Triangles);
+    vertices.resize(m_count * 6);
+    if (m_count == 0) {
+        return;
+    }
+
+    // Written in place, the array is reused between frames so this does not allocate once warm
+    sf::Vertex *out = &vertices[0];
+    for (size_t i = 0; i < m_count; i++) {
+        const float half = m_size[i] * 0.5f;
+        const float left = m_positionX[i] - half;
+        const float top = m_positionY[i] - half;
+        const float right = m_positionX[i] + half;
+        const float bottom = m_positionY[i] + half;
+
+        // Fade out over the particle's lifetime
+        sf::Color color = m_color[i];
+        color.a = static_cast<sf::Uint8>(color.a * std::min(m_life[i] * m_invLifetime[i], 1.f));
+
+        const sf::IntRect &rect = m_frames[m_frame[i]];
+        const float u0 = static_cast<float>(rect.left);
+        const float v0 = static_cast<float>(rect.top);
+        const float u1 = u0 + rect.width;
+        const float v1 = v0 + rect.height;
+
+        // Fields are set one by one, sf::Vertex's constructors are not inline
+        out[0].position = {left, top};
+        out[0].texCoords = {u0, v0};
+        out[1].position = {right, top};
+        out[1].texCoords = {u1, v0};
+        out[2].position = {right, bottom};
+        out[2].texCoords = {u1, v1};
+        out[5].position = {left, bottom};
+        out[5].texCoords = {u0, v1};
+        out[0].color = out[1].color = out[2].color = out[5].color = color;
+        out[3] = out[0];
+        out[4] = out[2];
+        out += 6;
+    }
+}
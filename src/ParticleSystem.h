@@ -0,0 +1,64 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "Config/GameConfig.h"
+#include "Constants.h"
+#include "Random.h"
+
+// Short lived sparks and debris. Particles are not entities: every attribute lives in its own
+// array so the update is a straight pass over floats, and dead particles are swapped out with
+// the last live one so the live range stays dense.
+class ParticleSystem
+{
+public:
+    explicit ParticleSystem(size_t capacity = Constants::PARTICLE_CAPACITY);
+    ~ParticleSystem() = default;
+
+    // Emits burst.count particles at position, fanned around direction by burst.spread.
+    // Particles past the capacity are dropped.
+    void emit(const sf::Vector2f &position, const sf::Vector2f &direction,
+              const ParticleBurst &burst);
+
+    void update(float deltaTime);
+    void clear() { m_count = 0; }
+
+    // Overwrites vertices with one textured quad (two triangles) per live particle
+    void writeVertices(sf::VertexArray &vertices) const;
+
+    // Atlas rects a particle may pick at emit time, all on the page of the first one.
+    // Defaults to the atlas white texel, i.e. plain coloured squares.
+    void setFrames(std::vector<sf::IntRect> frames, uint32_t page);
+    uint32_t getPage() const { return m_page; }
+
+    // Stream emit draws angles, speeds, lifetimes and frames from, see RandomService
+    void setRandom(const Random &random) { m_random = random; }
+
+    size_t getCount() const { return m_count; }
+    size_t getCapacity() const { return m_capacity; }
+    size_t getDroppedCount() const { return m_dropped; }
+
+private:
+    void kill(size_t index);
+
+    size_t m_capacity;
+    size_t m_count{0};
+    size_t m_dropped{0};
+
+    // Particle attributes, indexed together
+    std::vector<float> m_positionX;
+    std::vector<float> m_positionY;
+    std::vector<float> m_velocityX;
+    std::vector<float> m_velocityY;
+    std::vector<float> m_life; // seconds left
+    std::vector<float> m_invLifetime;
+    std::vector<float> m_size;
+    std::vector<sf::Color> m_color;
+    std::vector<uint16_t> m_frame;
+
+    std::vector<sf::IntRect> m_frames;
+    uint32_t m_page{0};
+    float m_drag{Constants::PARTICLE_DRAG};
+
+    Random m_random{0x5eed};
+};
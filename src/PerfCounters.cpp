@@ -0,0 +1,203 @@
+#include "PerfCounters.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#if defined(__linux__)
+#define SURVIVE_HAS_PERF 1
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const std::array<const char *, PerfCounters::COUNT> COUNTER_NAMES = {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"};
+
+#ifdef SURVIVE_HAS_PERF
+    struct EventType
+    {
+        uint32_t type;
+        uint64_t config;
+    };
+
+    constexpr EventType EVENT_TYPES[PerfCounters::COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    };
+
+    int openEvent(const EventType &event, int groupFd)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = event.type;
+        attr.config = event.config;
+        attr.disabled = groupFd == -1 ? 1 : 0; // the group starts when the leader is enabled
+        attr.exclude_kernel = 1;                // allowed with perf_event_paranoid up to 2
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // This thread, on any cpu
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+    }
+
+    // One counter group per thread, closed when the thread exits
+    struct ThreadCounters
+    {
+        bool opened{false};
+        int leader{-1};
+        int fds[PerfCounters::COUNT];
+        uint64_t ids[PerfCounters::COUNT]{};
+        uint32_t available{0};
+        int error{0};
+
+        ThreadCounters()
+        {
+            for (int &fd : fds) {
+                fd = -1;
+            }
+        }
+        ~ThreadCounters()
+        {
+            for (int fd : fds) {
+                if (fd != -1) {
+                    ::close(fd);
+                }
+            }
+        }
+
+        // Cycles leads the group, the other counters join it if this cpu has them
+        bool open()
+        {
+            opened = true;
+            for (int counter = 0; counter < PerfCounters::COUNT; counter++) {
+                int fd = openEvent(EVENT_TYPES[counter], leader);
+                if (fd == -1) {
+                    if (leader == -1) {
+                        error = errno;
+                        return false;
+                    }
+                    continue;
+                }
+                if (leader == -1) {
+                    leader = fd;
+                }
+                fds[counter] = fd;
+                ioctl(fd, PERF_EVENT_IOC_ID, &ids[counter]);
+                available |= 1u << counter;
+            }
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            return true;
+        }
+    };
+
+    thread_local ThreadCounters t_counters;
+#endif
+} // namespace
+
+const char *PerfCounters::getName(Counter counter)
+{
+    return COUNTER_NAMES[counter];
+}
+
+const std::array<const char *, PerfCounters::COUNT> &PerfCounters::getNames()
+{
+    return COUNTER_NAMES;
+}
+
+PerfCounters::Sample PerfCounters::Sample::operator-(const Sample &start) const
+{
+    Sample delta;
+    delta.valid = valid && start.valid;
+    delta.available = available & start.available;
+    for (size_t i = 0; i < COUNT; i++) {
+        delta.values[i] = values[i] >= start.values[i] ? values[i] - start.values[i] : 0;
+    }
+    return delta;
+}
+
+PerfCounters::Sample &PerfCounters::Sample::operator+=(const Sample &other)
+{
+    if (!other.valid) {
+        return *this;
+    }
+    available = valid ? available & other.available : other.available;
+    valid = true;
+    for (size_t i = 0; i < COUNT; i++) {
+        values[i] += other.values[i];
+    }
+    return *this;
+}
+
+void PerfCounters::reportUnsupported(const char *reason, int error)
+{
+    m_supported.store(false, std::memory_order_relaxed);
+    if (!m_reported.exchange(true)) {
+        std::cerr << "Hardware counters unavailable (" << reason;
+        if (error) {
+            std::cerr << ": " << std::strerror(error);
+        }
+        if (error == EACCES || error == EPERM) {
+            std::cerr << ", see /proc/sys/kernel/perf_event_paranoid";
+        }
+        std::cerr << "), only timings are reported" << std::endl;
+    }
+}
+
+bool PerfCounters::read(Sample &sample)
+{
+    sample.valid = false;
+    if (!isEnabled() || !isSupported()) {
+        return false;
+    }
+
+#ifdef SURVIVE_HAS_PERF
+    ThreadCounters &counters = t_counters;
+    if (!counters.opened && !counters.open()) {
+        reportUnsupported("perf_event_open failed", counters.error);
+        return false;
+    }
+    if (counters.leader == -1) {
+        return false;
+    }
+
+    // nr, time enabled, time running, then a value and id per counter
+    uint64_t buffer[3 + 2 * COUNT];
+    const ssize_t size = ::read(counters.leader, buffer, sizeof(buffer));
+    if (size < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+        return false;
+    }
+    const uint64_t count = buffer[0];
+    const uint64_t enabled = buffer[1];
+    const uint64_t running = buffer[2];
+
+    sample.values.fill(0);
+    for (uint64_t i = 0; i < count && i < COUNT; i++) {
+        const uint64_t value = buffer[3 + 2 * i];
+        const uint64_t id = buffer[4 + 2 * i];
+        for (size_t counter = 0; counter < COUNT; counter++) {
+            if ((counters.available & (1u << counter)) && counters.ids[counter] == id) {
+                // Multiplexed counters only ran part of the time, extrapolate
+                sample.values[counter] =
+                    running && running < enabled
+                        ? static_cast<uint64_t>(static_cast<double>(value) * enabled / running)
+                        : value;
+            }
+        }
+    }
+    sample.available = counters.available;
+    sample.valid = true;
+    return true;
+#else
+    reportUnsupported("only available on Linux", 0);
+    return false;
+#endif
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Hardware counters of the calling thread (cycles, instructions, cache and branch misses)
+// through Linux perf_event_open. Each thread opens its own counter group the first time it
+// reads, so a sample taken before and after a piece of work on the same thread counts only
+// that work, whichever core it ran on.
+//
+// Off until enabled. Where counters cannot be opened (other platforms, no PMU in a VM,
+// kernel.perf_event_paranoid too strict) reads fail, a single warning is printed and
+// everything else carries on with wall clock timings only.
+class PerfCounters
+{
+public:
+    enum Counter
+    {
+        Cycles,
+        Instructions,
+        L1DMisses, // L1 data cache read misses
+        LLCMisses, // last level cache misses
+        BranchMisses,
+        COUNT,
+    };
+
+    struct Sample
+    {
+        std::array<uint64_t, COUNT> values{};
+        uint32_t available{0}; // bit per Counter that could be opened
+        bool valid{false};
+
+        bool has(Counter counter) const { return valid && (available & (1u << counter)) != 0; }
+        double getIpc() const
+        {
+            return has(Cycles) && has(Instructions) && values[Cycles]
+                       ? static_cast<double>(values[Instructions]) / values[Cycles]
+                       : 0.0;
+        }
+        // Counts between two samples of the same thread
+        Sample operator-(const Sample &start) const;
+        Sample &operator+=(const Sample &other);
+    };
+
+    static PerfCounters &getInstance()
+    {
+        static PerfCounters instance;
+        return instance;
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    static const char *getName(Counter counter);
+    static const std::array<const char *, COUNT> &getNames();
+
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    // False once a thread failed to open the counters
+    bool isSupported() const { return m_supported.load(std::memory_order_relaxed); }
+
+    // Current totals of the calling thread, scaled up if the kernel had to multiplex them.
+    // Returns false when disabled or unsupported.
+    bool read(Sample &sample);
+
+private:
+    PerfCounters() = default;
+
+    void reportUnsupported(const char *reason, int error);
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<bool> m_supported{true};
+    std::atomic<bool> m_reported{false};
+};
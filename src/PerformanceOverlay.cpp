@@ -0,0 +1,234 @@
+#include "PerformanceOverlay.h"
+#include "Entity.h"
+#include "SystemScheduler.h"
+#include "Config/EntityConfigLoader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+    // 1234 -> "1.2k", keeps the counter lines short
+    const char *formatCount(uint64_t value, char *buffer, size_t size)
+    {
+        if (value >= 10'000'000)
+            std::snprintf(buffer, size, "%.1fM", value / 1e6);
+        else if (value >= 10'000)
+            std::snprintf(buffer, size, "%.1fk", value / 1e3);
+        else
+            std::snprintf(buffer, size, "%llu", static_cast<unsigned long long>(value));
+        return buffer;
+    }
+
+    constexpr unsigned CHARACTER_SIZE = 14;
+    constexpr float MARGIN = 10.f;
+    constexpr float PADDING = 8.f;
+    constexpr float BAR_WIDTH = 1.5f;
+    constexpr float GRAPH_WIDTH = PerformanceOverlay::HISTORY_SIZE * BAR_WIDTH;
+    constexpr float GRAPH_HEIGHT = 80.f;
+    constexpr float GRAPH_MAX_MS = 1000.f / 30.f; // a full height bar
+    constexpr float FRAME_144_MS = 1000.f / 144.f;
+    constexpr float FRAME_60_MS = 1000.f / 60.f;
+
+    const sf::Color PANEL_COLOR(0, 0, 0, 170);
+    const sf::Color GUIDE_COLOR(255, 255, 255, 90);
+    const sf::Color FAST_COLOR(80, 220, 100);
+    const sf::Color SLOW_COLOR(240, 200, 60);
+    const sf::Color DROPPED_COLOR(230, 70, 60);
+} // namespace
+
+PerformanceOverlay::PerformanceOverlay(const sf::Font &font)
+    : m_lineHeight(font.getLineSpacing(CHARACTER_SIZE))
+{
+    m_text.setFont(font);
+    m_text.setCharacterSize(CHARACTER_SIZE);
+    m_text.setFillColor(sf::Color::White);
+    m_text.setPosition(MARGIN + PADDING, MARGIN + PADDING);
+}
+
+void PerformanceOverlay::toggle()
+{
+    m_visible = !m_visible;
+    if (!m_visible) {
+        m_frame.geometry.clear();
+        m_frame.text.clear();
+        m_frame.textVersion++;
+    }
+    // Show fresh numbers straight away
+    m_sinceRefresh = REFRESH_SECONDS;
+}
+
+void PerformanceOverlay::update(const OverlayStats &stats)
+{
+    // The history keeps running while hidden, the graph is full as soon as it is shown
+    m_history[m_historyHead] = stats.frameMs;
+    m_historyHead = (m_historyHead + 1) % HISTORY_SIZE;
+    if (!m_visible) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    m_windowTotalMs += stats.frameMs;
+    m_windowMaxMs = std::max(m_windowMaxMs, stats.frameMs);
+    m_windowFrames++;
+    m_sinceRefresh += stats.frameMs / 1000.f;
+    if (m_sinceRefresh >= REFRESH_SECONDS) {
+        rebuildText(stats);
+        m_sinceRefresh = 0.f;
+        m_windowTotalMs = 0.f;
+        m_windowMaxMs = 0.f;
+        m_windowFrames = 0;
+    }
+    rebuildGeometry();
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    m_costMs = elapsed.count();
+}
+
+void PerformanceOverlay::rebuildText(const OverlayStats &stats)
+{
+    std::string &text = m_frame.text;
+    text.clear();
+    size_t lines = 0;
+    char line[128];
+    auto addLine = [&](int length) {
+        text.append(line, static_cast<size_t>(std::clamp(length, 0, int(sizeof(line)) - 1)));
+        text += '\n';
+        lines++;
+    };
+
+    const float averageMs = m_windowFrames ? m_windowTotalMs / m_windowFrames : stats.frameMs;
+    const float maxMs = m_windowFrames ? m_windowMaxMs : stats.frameMs;
+    addLine(std::snprintf(line, sizeof(line), "frame %.2f ms (%.0f fps), max %.2f ms", averageMs,
+                          averageMs > 0.f ? 1000.f / averageMs : 0.f, maxMs));
+    addLine(std::snprintf(line, sizeof(line), "update %.2f ms, overlay %.3f ms", stats.updateMs,
+                          m_costMs));
+    if (AllocTracker::isEnabled()) {
+        char bytes[16];
+        addLine(std::snprintf(line, sizeof(line), "update allocations %llu, %s bytes",
+                              static_cast<unsigned long long>(stats.updateAllocations.count),
+                              formatCount(stats.updateAllocations.bytes, bytes, 16)));
+    }
+
+    if (stats.scheduler) {
+        const PerfCounters &perf = PerfCounters::getInstance();
+        if (perf.isEnabled() && !perf.isSupported()) {
+            addLine(std::snprintf(line, sizeof(line), "hardware counters unavailable"));
+        }
+        for (size_t i = 0; i < stats.scheduler->getSystemCount(); i++) {
+            int length = std::snprintf(line, sizeof(line), "  %-12s %6.3f ms",
+                                       stats.scheduler->getSystemName(i).c_str(),
+                                       stats.scheduler->getLastDurationMs(i));
+            if (AllocTracker::isEnabled() && length > 0 && length < int(sizeof(line))) {
+                length += std::snprintf(line + length, sizeof(line) - length, ", %llu allocations",
+                                        static_cast<unsigned long long>(
+                                            stats.scheduler->getLastAllocations(i).count));
+            }
+            addLine(length);
+
+            const PerfCounters::Sample &counters = stats.scheduler->getLastCounters(i);
+            if (!counters.valid) {
+                continue;
+            }
+            char l1[16], llc[16], branch[16];
+            addLine(std::snprintf(
+                line, sizeof(line), "    ipc %.2f, miss L1 %s LLC %s branch %s",
+                counters.getIpc(), formatCount(counters.values[PerfCounters::L1DMisses], l1, 16),
+                formatCount(counters.values[PerfCounters::LLCMisses], llc, 16),
+                formatCount(counters.values[PerfCounters::BranchMisses], branch, 16)));
+        }
+    }
+
+    addLine(std::snprintf(line, sizeof(line), "collision pairs %zu, contacts %zu, particles %zu",
+                          stats.candidatePairs, stats.contacts, stats.particles));
+
+    if (stats.entities) {
+        std::array<size_t, ENTITY_TYPE_COUNT> counts{};
+        for (const auto &entity : *stats.entities) {
+            counts[toIndex(entity->getType())]++;
+        }
+        addLine(std::snprintf(line, sizeof(line), "entities %zu", stats.entities->size()));
+        for (size_t type = 0; type < ENTITY_TYPE_COUNT; type++) {
+            if (counts[type] == 0) {
+                continue;
+            }
+            addLine(std::snprintf(line, sizeof(line), "  %-16s %zu",
+                                  EntityConfigLoader::getTypeName(static_cast<EntityType>(type)),
+                                  counts[type]));
+        }
+    }
+
+    if (!text.empty()) {
+        text.pop_back();
+    }
+    m_textLines = lines;
+    m_frame.textVersion++;
+}
+
+void PerformanceOverlay::rebuildGeometry()
+{
+    const float textHeight = m_textLines * m_lineHeight;
+    const sf::FloatRect panel(MARGIN, MARGIN, GRAPH_WIDTH + 2.f * PADDING,
+                              textHeight + GRAPH_HEIGHT + 3.f * PADDING);
+    const float graphLeft = MARGIN + PADDING;
+    const float graphBottom = panel.top + panel.height - PADDING;
+    const float pixelsPerMs = GRAPH_HEIGHT / GRAPH_MAX_MS;
+
+    // Panel, one bar per frame and two budget lines, written in place
+    sf::VertexArray &vertices = m_frame.geometry;
+    vertices.setPrimitiveType(sf::Triangles);
+    vertices.resize((HISTORY_SIZE + 3) * 6);
+    size_t vertex = 0;
+
+    appendQuad(vertex, panel, PANEL_COLOR);
+
+    for (size_t i = 0; i < HISTORY_SIZE; i++) {
+        const float ms = m_history[(m_historyHead + i) % HISTORY_SIZE];
+        const float height = std::min(ms, GRAPH_MAX_MS) * pixelsPerMs;
+        const sf::Color &color =
+            ms <= FRAME_60_MS ? FAST_COLOR : (ms <= GRAPH_MAX_MS ? SLOW_COLOR : DROPPED_COLOR);
+        appendQuad(vertex, {graphLeft + i * BAR_WIDTH, graphBottom - height, BAR_WIDTH, height},
+                   color);
+    }
+
+    for (float ms : {FRAME_144_MS, FRAME_60_MS}) {
+        appendQuad(vertex, {graphLeft, graphBottom - ms * pixelsPerMs, GRAPH_WIDTH, 1.f},
+                   GUIDE_COLOR);
+    }
+}
+
+void PerformanceOverlay::appendQuad(size_t &vertex, const sf::FloatRect &rect,
+                                    const sf::Color &color)
+{
+    const sf::Vector2f topLeft(rect.left, rect.top);
+    const sf::Vector2f topRight(rect.left + rect.width, rect.top);
+    const sf::Vector2f bottomRight(rect.left + rect.width, rect.top + rect.height);
+    const sf::Vector2f bottomLeft(rect.left, rect.top + rect.height);
+
+    sf::VertexArray &vertices = m_frame.geometry;
+    vertices[vertex++] = sf::Vertex(topLeft, color);
+    vertices[vertex++] = sf::Vertex(topRight, color);
+    vertices[vertex++] = sf::Vertex(bottomRight, color);
+    vertices[vertex++] = sf::Vertex(topLeft, color);
+    vertices[vertex++] = sf::Vertex(bottomRight, color);
+    vertices[vertex++] = sf::Vertex(bottomLeft, color);
+}
+
+void PerformanceOverlay::draw(sf::RenderTarget &target, const OverlayFrame &frame)
+{
+    if (frame.geometry.getVertexCount() == 0) {
+        return;
+    }
+    if (frame.textVersion != m_drawnVersion) {
+        m_text.setString(frame.text);
+        m_drawnVersion = frame.textVersion;
+    }
+
+    // Screen space, whatever the game view is
+    const sf::View view = target.getView();
+    target.setView(target.getDefaultView());
+    target.draw(frame.geometry);
+    target.draw(m_text);
+    target.setView(view);
+}
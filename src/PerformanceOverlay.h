@@ -0,0 +1,71 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "AllocTracker.h"
+#include "RenderSnapshot.h"
+#include "Types.h"
+
+class Entity;
+class SystemScheduler;
+
+// What the overlay shows, gathered by Game once per tick
+struct OverlayStats
+{
+    float frameMs;  // time since the previous tick
+    float updateMs; // time spent in Game::update
+    AllocCounts updateAllocations;
+    const SystemScheduler *scheduler;
+    const std::vector<std::unique_ptr<Entity>> *entities;
+    size_t candidatePairs;
+    size_t contacts; // collision events of the last update
+    size_t particles;
+};
+
+// Frame time, per-system timings, entity counts by type, collision pairs and a frame time graph,
+// drawn in screen space over the game. Split like RenderSystem: update builds an OverlayFrame on
+// the simulation side, draw only reads a frame. The panel and graph are one vertex array and the
+// text is a single sf::Text that is only re-laid out when the text changes, a few times a second.
+class PerformanceOverlay
+{
+public:
+    static constexpr size_t HISTORY_SIZE = 240; // frames in the graph
+    static constexpr float REFRESH_SECONDS = 0.25f;
+
+    explicit PerformanceOverlay(const sf::Font &font);
+
+    bool isVisible() const { return m_visible; }
+    void toggle();
+
+    // Simulation side: records the frame and rebuilds the geometry while visible
+    void update(const OverlayStats &stats);
+    const OverlayFrame &getFrame() const { return m_frame; }
+
+    // Drawing side: may run on the render thread with a frame copied into a snapshot
+    void draw(sf::RenderTarget &target, const OverlayFrame &frame);
+
+private:
+    void rebuildText(const OverlayStats &stats);
+    void rebuildGeometry();
+    void appendQuad(size_t &vertex, const sf::FloatRect &rect, const sf::Color &color);
+
+    bool m_visible{false};
+    float m_lineHeight;
+
+    // Simulation side
+    std::array<float, HISTORY_SIZE> m_history{}; // frame ms, oldest first from m_historyHead
+    size_t m_historyHead{0};
+    float m_sinceRefresh{REFRESH_SECONDS};
+    float m_windowTotalMs{0.f};
+    float m_windowMaxMs{0.f};
+    size_t m_windowFrames{0};
+    size_t m_textLines{0};
+    double m_costMs{0.0}; // overlay update time, shown on the next refresh
+    OverlayFrame m_frame;
+
+    // Drawing side
+    sf::Text m_text;
+    uint64_t m_drawnVersion{0};
+};
@@ -0,0 +1,161 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+thread_local Profiler::ThreadBuffer *Profiler::t_buffer = nullptr;
+
+namespace {
+    void writeJsonString(std::ostream &out, const std::string &text)
+    {
+        out << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\')
+                out << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20)
+                out << ' ';
+            else
+                out << c;
+        }
+        out << '"';
+    }
+
+    // Copies the events still in a ring into out, skipping slots the owner is writing or has
+    // overwritten since
+    template <typename T>
+    void copyLive(const Profiler::Slot<T> *ring, size_t capacity,
+                  const std::atomic<uint64_t> &headCounter, uint64_t clearedAt, std::vector<T> &out)
+    {
+        const uint64_t head = headCounter.load(std::memory_order_acquire);
+        const uint64_t begin = std::max(clearedAt, head > capacity ? head - capacity : 0);
+        out.clear();
+        T event;
+        for (uint64_t i = begin; i < head; i++) {
+            if (ring[i % capacity].read(i, event)) {
+                out.push_back(event);
+            }
+        }
+    }
+
+    // Chrome expects microseconds
+    void writeMicroseconds(std::ostream &out, uint64_t ns)
+    {
+        out << ns / 1000 << "." << (ns % 1000) / 100;
+    }
+} // namespace
+
+Profiler::ThreadBuffer *Profiler::registerThread()
+{
+    // Once per thread, the buffer outlives the thread so its events can still be written out
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_buffers.push_back(std::make_unique<ThreadBuffer>());
+    t_buffer = m_buffers.back().get();
+    t_buffer->threadId = static_cast<uint32_t>(m_buffers.size());
+    t_buffer->name = "thread " + std::to_string(t_buffer->threadId);
+    return t_buffer;
+}
+
+void Profiler::setThreadName(const std::string &name)
+{
+    ThreadBuffer *buffer = t_buffer ? t_buffer : registerThread();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    buffer->name = name;
+}
+
+const char *Profiler::intern(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_names.insert(name).first->c_str();
+}
+
+void Profiler::recordCounters(const char *name, const uint64_t *values,
+                              const char *const *valueNames, size_t count, uint32_t mask)
+{
+    ThreadBuffer *buffer = t_buffer ? t_buffer : registerThread();
+    const uint64_t head = buffer->counterHead.load(std::memory_order_relaxed);
+    CounterEvent event{};
+    event.name = name;
+    event.timeNs = now();
+    event.valueNames = valueNames;
+    event.count = static_cast<uint32_t>(std::min(count, MAX_COUNTER_VALUES));
+    event.mask = mask;
+    std::copy(values, values + event.count, event.values);
+    buffer->counters[head % COUNTER_RING_CAPACITY].write(head, event);
+    buffer->counterHead.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &buffer : m_buffers) {
+        buffer->clearedAt = buffer->head.load(std::memory_order_acquire);
+        buffer->countersClearedAt = buffer->counterHead.load(std::memory_order_acquire);
+    }
+}
+
+bool Profiler::writeChromeTrace(const std::string &path)
+{
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Unable to write trace " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Event> events;
+    std::vector<CounterEvent> counters;
+    size_t written = 0;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto &buffer : m_buffers) {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << buffer->threadId << ",\"args\":{\"name\":";
+        writeJsonString(out, buffer->name);
+        out << "}}";
+        first = false;
+
+        copyLive(buffer->events.get(), RING_CAPACITY, buffer->head, buffer->clearedAt, events);
+        for (const Event &event : events) {
+            out << ",\n{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"ts\":";
+            writeMicroseconds(out, event.startNs);
+            out << ",\"dur\":";
+            writeMicroseconds(out, event.durationNs);
+            out << "}";
+            written++;
+        }
+
+        copyLive(buffer->counters.get(), COUNTER_RING_CAPACITY, buffer->counterHead,
+                 buffer->countersClearedAt, counters);
+        for (const CounterEvent &event : counters) {
+            out << ",\n{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ph\":\"C\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"ts\":";
+            writeMicroseconds(out, event.timeNs);
+            out << ",\"args\":{";
+            bool firstValue = true;
+            for (uint32_t i = 0; i < event.count; i++) {
+                if (event.mask & (1u << i)) {
+                    out << (firstValue ? "" : ",");
+                    writeJsonString(out, event.valueNames[i]);
+                    out << ":" << event.values[i];
+                    firstValue = false;
+                }
+            }
+            out << "}}";
+            written++;
+        }
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        std::cerr << "Unable to write trace " << path << std::endl;
+        return false;
+    }
+    std::cout << "Wrote " << written << " profile events from " << m_buffers.size()
+              << " threads to " << path << std::endl;
+    return true;
+}
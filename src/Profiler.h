@@ -0,0 +1,237 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+// Records timed scopes into a ring buffer per thread and exports them as Chrome trace JSON
+// (chrome://tracing, ui.perfetto.dev). Recording takes no lock: each thread only ever writes its
+// own buffer, and every slot carries a sequence number so an export running at the same time
+// skips slots that are being written. Once a buffer is full the oldest events are overwritten,
+// so a trace holds the last RING_CAPACITY scopes of every thread.
+//
+// Counter samples (e.g. hardware counters of a system) go into a second, smaller ring and show
+// up as counter tracks next to the scopes.
+//
+// The markers are PROFILE_SCOPE(name), the PROFILE_SUM family and PROFILE_COUNTERS. They only
+// exist when SURVIVE_PROFILING is defined, otherwise they expand to nothing.
+class Profiler
+{
+public:
+    static constexpr size_t RING_CAPACITY = 1 << 16;
+    static constexpr size_t COUNTER_RING_CAPACITY = 1 << 12;
+    static constexpr size_t MAX_COUNTER_VALUES = 8;
+
+    struct Event
+    {
+        const char *name; // string literal or interned
+        uint64_t startNs;
+        uint64_t durationNs;
+    };
+
+    struct CounterEvent
+    {
+        const char *name; // string literal or interned
+        uint64_t timeNs;
+        const char *const *valueNames; // static, one per value
+        uint32_t count;
+        uint32_t mask; // bit per value that was measured
+        uint64_t values[MAX_COUNTER_VALUES];
+    };
+
+    // One ring slot, a seqlock: the sequence is odd while the owning thread writes event number
+    // index and 2 * index + 2 once it is complete. The payload is kept in relaxed atomic words,
+    // so a reader copying it concurrently is not a data race, and a copy whose sequence changed
+    // meanwhile is thrown away.
+    template <typename T> struct Slot
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "slots are copied word by word");
+        static constexpr size_t WORDS = (sizeof(T) + 7) / 8;
+
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> words[WORDS]{};
+
+        void write(uint64_t index, const T &value)
+        {
+            uint64_t local[WORDS] = {};
+            std::memcpy(local, &value, sizeof(T));
+            // Release on the words keeps the odd sequence ahead of them. No fences, which
+            // ThreadSanitizer does not model; on x86 these are plain moves either way.
+            sequence.store(2 * index + 1, std::memory_order_relaxed);
+            for (size_t w = 0; w < WORDS; w++) {
+                words[w].store(local[w], std::memory_order_release);
+            }
+            sequence.store(2 * index + 2, std::memory_order_release);
+        }
+
+        // False when the slot does not hold a complete copy of event number index
+        bool read(uint64_t index, T &value) const
+        {
+            const uint64_t expected = 2 * index + 2;
+            if (sequence.load(std::memory_order_acquire) != expected) {
+                return false;
+            }
+            uint64_t local[WORDS];
+            // Acquire on the words keeps the second sequence load behind them
+            for (size_t w = 0; w < WORDS; w++) {
+                local[w] = words[w].load(std::memory_order_acquire);
+            }
+            if (sequence.load(std::memory_order_relaxed) != expected) {
+                return false;
+            }
+            std::memcpy(&value, local, sizeof(T));
+            return true;
+        }
+    };
+
+    static Profiler &getInstance()
+    {
+        static Profiler instance;
+        return instance;
+    }
+
+    Profiler(const Profiler &) = delete;
+    Profiler &operator=(const Profiler &) = delete;
+
+    // Nanoseconds since the profiler was created
+    uint64_t now() const
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now() - m_epoch)
+                                         .count());
+    }
+
+    void record(const char *name, uint64_t startNs, uint64_t endNs)
+    {
+        ThreadBuffer *buffer = t_buffer ? t_buffer : registerThread();
+        const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+        buffer->events[head % RING_CAPACITY].write(head, {name, startNs, endNs - startNs});
+        buffer->head.store(head + 1, std::memory_order_release);
+    }
+
+    // count values named by valueNames, as of now; values whose bit is clear in mask are skipped
+    void recordCounters(const char *name, const uint64_t *values, const char *const *valueNames,
+                        size_t count, uint32_t mask);
+
+    // Names the calling thread in the trace
+    void setThreadName(const std::string &name);
+    // Stable copy of a name that is not a literal, for scopes named at runtime
+    const char *intern(const std::string &name);
+
+    // Writes everything still in the buffers. Scopes may keep being recorded meanwhile,
+    // events being written or overwritten while they are copied are left out.
+    bool writeChromeTrace(const std::string &path);
+    void clear();
+
+private:
+    struct ThreadBuffer
+    {
+        std::unique_ptr<Slot<Event>[]> events{new Slot<Event>[RING_CAPACITY]};
+        std::atomic<uint64_t> head{0}; // events ever recorded
+        std::unique_ptr<Slot<CounterEvent>[]> counters{
+            new Slot<CounterEvent>[COUNTER_RING_CAPACITY]};
+        std::atomic<uint64_t> counterHead{0};
+        uint32_t threadId{0};
+        std::string name;
+        uint64_t clearedAt{0}; // heads at the last clear, under m_mutex
+        uint64_t countersClearedAt{0};
+    };
+
+    Profiler() = default;
+
+    ThreadBuffer *registerThread();
+
+    static thread_local ThreadBuffer *t_buffer;
+
+    const std::chrono::steady_clock::time_point m_epoch{std::chrono::steady_clock::now()};
+    std::mutex m_mutex; // guards the lists below, recording only takes it once per thread
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+    std::unordered_set<std::string> m_names;
+};
+
+#ifdef SURVIVE_PROFILING
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char *name)
+        : m_name(name)
+        , m_start(Profiler::getInstance().now())
+    {}
+    ~ProfileScope()
+    {
+        Profiler &profiler = Profiler::getInstance();
+        profiler.record(m_name, m_start, profiler.now());
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+    const char *m_name;
+    uint64_t m_start;
+};
+
+// Sums many short scopes, e.g. one per iteration of a hot loop, and records them as a single
+// event when it goes out of scope. The event starts where the sum was declared, or right after
+// the event of another sum so the two sit side by side in the trace.
+class ProfileSum
+{
+public:
+    explicit ProfileSum(const char *name, const ProfileSum *after = nullptr)
+        : m_name(name)
+        , m_start(Profiler::getInstance().now())
+        , m_after(after)
+    {}
+    ~ProfileSum()
+    {
+        const uint64_t start = m_after ? m_after->m_start + m_after->m_total : m_start;
+        Profiler::getInstance().record(m_name, start, start + m_total);
+    }
+
+    ProfileSum(const ProfileSum &) = delete;
+    ProfileSum &operator=(const ProfileSum &) = delete;
+
+    class Scope
+    {
+    public:
+        explicit Scope(ProfileSum &sum)
+            : m_sum(sum)
+            , m_start(Profiler::getInstance().now())
+        {}
+        ~Scope() { m_sum.m_total += Profiler::getInstance().now() - m_start; }
+
+    private:
+        ProfileSum &m_sum;
+        uint64_t m_start;
+    };
+
+private:
+    const char *m_name;
+    uint64_t m_start;
+    uint64_t m_total{0};
+    const ProfileSum *m_after;
+};
+
+#define SURVIVE_PROFILE_CONCAT_INNER(a, b) a##b
+#define SURVIVE_PROFILE_CONCAT(a, b) SURVIVE_PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope SURVIVE_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_THREAD_NAME(name) Profiler::getInstance().setThreadName(name)
+#define PROFILE_COUNTERS(name, values, valueNames, count, mask)                                    \
+    Profiler::getInstance().recordCounters(name, values, valueNames, count, mask)
+#define PROFILE_SUM(var, name) ProfileSum var(name)
+#define PROFILE_SUM_AFTER(var, name, after) ProfileSum var(name, &after)
+#define PROFILE_SUM_SCOPE(var) ProfileSum::Scope SURVIVE_PROFILE_CONCAT(profileSum, __LINE__)(var)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_THREAD_NAME(name) ((void)0)
+#define PROFILE_COUNTERS(name, values, valueNames, count, mask) ((void)0)
+#define PROFILE_SUM(var, name) ((void)0)
+#define PROFILE_SUM_AFTER(var, name, after) ((void)0)
+#define PROFILE_SUM_SCOPE(var) ((void)0)
+#endif
@@ -0,0 +1,47 @@
+#include "Random.h"
+
+namespace {
+    uint64_t splitMix(uint64_t &x)
+    {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+} // namespace
+
+Random::Random(uint64_t seed)
+{
+    for (uint64_t &word : m_state) {
+        word = splitMix(seed);
+    }
+}
+
+void Random::fill(float *values, size_t count, float min, float max)
+{
+    const float scale = (max - min) * 0x1.0p-24f;
+    for (size_t i = 0; i < count; i++) {
+        values[i] = min + static_cast<float>((*this)() >> 40) * scale;
+    }
+}
+
+void Random::fill(sf::Vector2f *points, size_t count, const sf::FloatRect &area)
+{
+    // One draw per point, x from the top bits and y from the bottom ones
+    const float scaleX = area.width * 0x1.0p-24f;
+    const float scaleY = area.height * 0x1.0p-24f;
+    for (size_t i = 0; i < count; i++) {
+        const uint64_t bits = (*this)();
+        points[i].x = area.left + static_cast<float>(bits >> 40) * scaleX;
+        points[i].y = area.top + static_cast<float>(bits & 0xffffff) * scaleY;
+    }
+}
+
+Random RandomService::getStream(Stream stream, uint64_t index) const
+{
+    // Mixed so neighbouring streams and indices start far apart
+    uint64_t x = m_seed;
+    uint64_t key = splitMix(x) ^ (uint64_t(stream) * 0xd1342543de82ef95ull);
+    key = splitMix(key) ^ index;
+    return Random(splitMix(key));
+}
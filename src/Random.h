@@ -0,0 +1,79 @@
+#pragma once
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+
+// xoshiro256**: 32 bytes of state, a few instructions per number and the same sequence on
+// every platform, unlike std::mt19937 with the standard distributions. Usable as a
+// UniformRandomBitGenerator, but the helpers below are what the game draws with.
+class Random
+{
+public:
+    using result_type = uint64_t;
+
+    // The state is expanded from seed with splitmix64, any seed including 0 is fine
+    explicit Random(uint64_t seed = 0);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    result_type operator()()
+    {
+        const uint64_t result = rotate(m_state[1] * 5, 7) * 9;
+        const uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotate(m_state[3], 45);
+        return result;
+    }
+
+    // [0, 1), from the top 24 bits
+    float nextFloat() { return static_cast<float>((*this)() >> 40) * 0x1.0p-24f; }
+    // [min, max)
+    float range(float min, float max) { return min + (max - min) * nextFloat(); }
+    // [0, bound), by multiply and shift. The bias is below 2^-32 for any bound.
+    uint32_t below(uint32_t bound)
+    {
+        return static_cast<uint32_t>(((*this)() >> 32) * bound >> 32);
+    }
+
+    // Bulk spawns: count values in [min, max), or count points inside area
+    void fill(float *values, size_t count, float min, float max);
+    void fill(sf::Vector2f *points, size_t count, const sf::FloatRect &area);
+
+private:
+    static uint64_t rotate(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t m_state[4];
+};
+
+// Hands out independent Random streams derived from one world seed. Each system asks for its
+// own stream once and keeps it, so what one system draws never shifts another's sequence.
+// Work split into jobs takes one stream per job index rather than per thread, the numbers then
+// do not depend on which worker ran the job.
+class RandomService
+{
+public:
+    enum Stream : uint64_t
+    {
+        Spawn,
+        Particles,
+        Bench, // survive_bench scenario setup
+    };
+
+    explicit RandomService(uint64_t seed = 0)
+        : m_seed(seed)
+    {}
+
+    void setSeed(uint64_t seed) { m_seed = seed; }
+    uint64_t getSeed() const { return m_seed; }
+
+    Random getStream(Stream stream, uint64_t index = 0) const;
+
+private:
+    uint64_t m_seed;
+};
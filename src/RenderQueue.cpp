@@ -0,0 +1,54 @@
+#include "RenderQueue.h"
+
+#include <array>
+#include <cstring>
+
+uint64_t RenderQueue::makeKey(uint8_t layer, uint32_t page, float depth)
+{
+    // Map the float onto an unsigned integer with the same ordering
+    uint32_t bits;
+    std::memcpy(&bits, &depth, sizeof(bits));
+    bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+
+    return (static_cast<uint64_t>(layer) << 56) | (static_cast<uint64_t>(page & 0xFF) << 48) |
+           (static_cast<uint64_t>(bits) << 16);
+}
+
+void RenderQueue::sort(const std::vector<RenderInstance> &instances)
+{
+    const size_t count = instances.size();
+    m_keys.resize(count);
+    m_keysScratch.resize(count);
+    m_order.resize(count);
+    m_orderScratch.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+        m_keys[i] = instances[i].sortKey;
+        m_order[i] = static_cast<uint32_t>(i);
+    }
+
+    std::array<size_t, 256> histogram;
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+        histogram.fill(0);
+        for (size_t i = 0; i < count; i++) {
+            histogram[(m_keys[i] >> shift) & 0xFF]++;
+        }
+        if (count == 0 || histogram[(m_keys[0] >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (auto &bucket : histogram) {
+            size_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (size_t i = 0; i < count; i++) {
+            size_t destination = histogram[(m_keys[i] >> shift) & 0xFF]++;
+            m_keysScratch[destination] = m_keys[i];
+            m_orderScratch[destination] = m_order[i];
+        }
+        m_keys.swap(m_keysScratch);
+        m_order.swap(m_orderScratch);
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "RenderSnapshot.h"
+
+// Orders a frame's sprites by their 64-bit sort key.
+// Key layout, most significant first: layer (8) | atlas page (8) | depth (32) | unused (16).
+// Sorting by page inside a layer keeps texture changes to at most one per page per layer.
+class RenderQueue
+{
+public:
+    static uint64_t makeKey(uint8_t layer, uint32_t page, float depth);
+
+    // Stable LSD radix sort, 8 bits per pass; passes where every key has the same byte are
+    // skipped, so unused or uniform fields cost one histogram pass each
+    void sort(const std::vector<RenderInstance> &instances);
+
+    const std::vector<uint32_t> &getOrder() const { return m_order; }
+
+private:
+    std::vector<uint64_t> m_keys;
+    std::vector<uint64_t> m_keysScratch;
+    std::vector<uint32_t> m_order;
+    std::vector<uint32_t> m_orderScratch;
+};
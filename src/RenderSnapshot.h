@@ -0,0 +1,35 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Everything needed to draw one visible sprite, detached from the entity that produced it
+struct RenderInstance
+{
+    sf::Transform transform; // entity * sprite transform
+    sf::IntRect textureRect; // atlas space
+    sf::Color color;
+    uint32_t page;
+    uint64_t sortKey; // see RenderQueue::makeKey
+};
+
+// Screen space performance overlay, see PerformanceOverlay. Empty while it is hidden.
+struct OverlayFrame
+{
+    sf::VertexArray geometry{sf::Triangles}; // panel and frame time graph, untextured
+    std::string text;
+    uint64_t textVersion{0}; // bumped when text changes, so the drawing side can keep its sf::Text
+};
+
+// Immutable picture of one simulation tick, produced by the simulation and consumed by drawing
+struct RenderSnapshot
+{
+    sf::View view;
+    std::vector<RenderInstance> sprites;
+    sf::VertexArray particles{sf::Triangles}; // world space quads on one atlas page
+    uint32_t particlePage{0};
+    sf::VertexArray debug{sf::Triangles};
+    OverlayFrame overlay;
+    uint64_t tick{0};
+};
@@ -2,69 +2,151 @@
 #include "Entity.h"
 #include "Components/VisualComponent.h"
 #include "Components/TransformComponent.h"
-#include "Components/CollisionComponent.h"
-#include "Components/DirectionComponent.h"
-#include "Constants.h"
+#include "DebugDraw.h"
+#include "Profiler.h"
+#include "ParticleSystem.h"
+#include "TextureAtlas.h"
+#include <cmath>
 
 void RenderSystem::draw(sf::RenderTarget &target, sf::RenderStates states,
                         const std::vector<std::unique_ptr<Entity>> &entities)
 {
-    for (const auto &entity : entities) {
-        auto *transform = entity->getComponent<TransformComponent>();
-        if (!transform) {
-            continue;
-        }
-        auto *visual = entity->getComponent<VisualComponent>();
-        auto *collision = entity->getComponent<CollisionComponent>();
-        auto *dir = entity->getComponent<DirectionComponent>();
+    PROFILE_SCOPE("RenderSystem::draw");
+    buildSnapshot(target.getView(), entities, m_snapshot);
+    drawSnapshot(target, states, m_snapshot);
+}
 
-        prepareEntity(visual, collision, dir);
+void RenderSystem::buildSnapshot(const sf::View &view,
+                                 const std::vector<std::unique_ptr<Entity>> &entities,
+                                 RenderSnapshot &snapshot)
+{
+    PROFILE_SCOPE("RenderSystem::buildSnapshot");
+    cull(view, entities);
 
-        sf::RenderStates entityStates = states;
-        entityStates.transform *= transform->getTransform();
+    snapshot.view = view;
+    snapshot.sprites.clear();
+    for (size_t index : m_visible) {
+        const Drawn &drawn = m_drawables[index];
+        const uint32_t page = static_cast<uint32_t>(drawn.visual->getAtlasPage());
+        // y sorted sprites are ordered by their entity's position, the rest keep entity order
+        const float depth = drawn.visual->isYSorted() ? drawn.transform->position.y : 0.f;
+        snapshot.sprites.push_back(
+            {drawn.transform->getTransform() * drawn.visual->getSpriteTransform(),
+             drawn.visual->getTextureRect(), drawn.visual->getColor(), page,
+             RenderQueue::makeKey(static_cast<uint8_t>(drawn.visual->getLayer()), page, depth)});
+    }
 
-        drawEntity(target, entityStates, visual, collision);
+    if (m_particles) {
+        m_particles->writeVertices(snapshot.particles);
+        snapshot.particlePage = m_particles->getPage();
+    }
+    else {
+        snapshot.particles.clear();
     }
+
+    if (m_debugDraw)
+        snapshot.debug = m_debugDraw->getVertices();
+    else
+        snapshot.debug.clear();
 }
 
-void RenderSystem::prepareEntity(VisualComponent *visual, CollisionComponent *collision,
-                                 DirectionComponent *dir) const
+void RenderSystem::drawSnapshot(sf::RenderTarget &target, sf::RenderStates states,
+                                const RenderSnapshot &snapshot)
 {
-    // Sprite Flipping
-    // if (visual && dir && visual->isEnabled()) {
-    //     sf::Vector2f scale = visual->getScale();
-    //     float absScaleX = std::abs(scale.x);
-
-    //     if (dir->isFacingLeft() && scale.x > 0)
-    //         visual->setScale({-absScaleX, scale.y});
-    //     else if (dir->isFacingRight() && scale.x < 0)
-    //         visual->setScale({absScaleX, scale.y});
-    // }
-
-    // collision outline
-    if (Constants::DEBUG_DRAW && collision && collision->isEnabled()) {
-        sf::Shape *debugShape = collision->getDebugShape();
-        if (debugShape) {
-            if (collision->isColliding)
-                debugShape->setOutlineColor(sf::Color::Red);
-            else
-                debugShape->setOutlineColor(sf::Color::White);
+    PROFILE_SCOPE("RenderSystem::drawSnapshot");
+    {
+        PROFILE_SCOPE("RenderQueue::sort");
+        m_queue.sort(snapshot.sprites);
+    }
+
+    m_drawCalls = 0;
+    m_textureChanges = 0;
+    m_batchPage = NO_PAGE;
+    m_spriteBatch.clear();
+    for (uint32_t index : m_queue.getOrder()) {
+        const RenderInstance &instance = snapshot.sprites[index];
+        // Sheets share the atlas, so only a page change breaks the batch
+        if (instance.page != m_batchPage) {
+            flushBatch(target, states);
+            m_batchPage = instance.page;
+            m_textureChanges++;
         }
+        appendInstance(instance);
+    }
+    flushBatch(target, states);
+
+    // Particles sit above every sprite layer, streamed as a single batch
+    if (snapshot.particles.getVertexCount() > 0) {
+        states.texture = &TextureAtlas::getInstance().getTexture(snapshot.particlePage);
+        target.draw(snapshot.particles, states);
+        m_drawCalls++;
+    }
+
+    // Debug geometry goes on top of all sprites, in one draw call
+    if (snapshot.debug.getVertexCount() > 0) {
+        states.texture = nullptr;
+        target.draw(snapshot.debug, states);
     }
 }
 
-void RenderSystem::drawEntity(sf::RenderTarget &target, sf::RenderStates states,
-                              VisualComponent *visual, CollisionComponent *collision) const
+void RenderSystem::cull(const sf::View &view, const std::vector<std::unique_ptr<Entity>> &entities)
 {
-    // draw visual component
-    if (visual && visual->isEnabled()) {
-        target.draw(*visual, states);
-    }
+    PROFILE_SCOPE("RenderSystem::cull");
+    m_drawables.clear();
+    m_visibilityGrid.clear();
 
-    // Draw collision Debug boundaries
-    if (Constants::DEBUG_DRAW) {
-        if (collision && collision->isEnabled()) {
-            target.draw(*collision, states);
+    for (const auto &entity : entities) {
+        auto *transform = entity->getComponent<TransformComponent>();
+        auto *visual = entity->getComponent<VisualComponent>();
+        if (!transform || !visual || !visual->isEnabled()) {
+            continue;
         }
+        m_visibilityGrid.insert(m_drawables.size(), visual->getBounds(transform->getTransform()));
+        m_drawables.push_back({visual, transform});
+    }
+
+    // Axis aligned world rectangle covered by the view, rotation included
+    const sf::FloatRect viewRect =
+        view.getInverseTransform().transformRect(sf::FloatRect(-1.f, -1.f, 2.f, 2.f));
+
+    // Indices come back ascending, so the draw order stays the entity order
+    m_visibilityGrid.query(viewRect, m_visible);
+    m_visibleCount = m_visible.size();
+    m_culledCount = m_drawables.size() - m_visibleCount;
+}
+
+void RenderSystem::appendInstance(const RenderInstance &instance)
+{
+    const sf::Transform &t = instance.transform;
+    const sf::IntRect &rect = instance.textureRect;
+
+    float width = static_cast<float>(std::abs(rect.width));
+    float height = static_cast<float>(std::abs(rect.height));
+    float left = static_cast<float>(rect.left);
+    float right = left + rect.width;
+    float top = static_cast<float>(rect.top);
+    float bottom = top + rect.height;
+
+    sf::Vertex topLeft(t.transformPoint(0.f, 0.f), instance.color, {left, top});
+    sf::Vertex topRight(t.transformPoint(width, 0.f), instance.color, {right, top});
+    sf::Vertex bottomRight(t.transformPoint(width, height), instance.color, {right, bottom});
+    sf::Vertex bottomLeft(t.transformPoint(0.f, height), instance.color, {left, bottom});
+
+    m_spriteBatch.append(topLeft);
+    m_spriteBatch.append(topRight);
+    m_spriteBatch.append(bottomRight);
+    m_spriteBatch.append(topLeft);
+    m_spriteBatch.append(bottomRight);
+    m_spriteBatch.append(bottomLeft);
+}
+
+void RenderSystem::flushBatch(sf::RenderTarget &target, sf::RenderStates states)
+{
+    if (m_spriteBatch.getVertexCount() == 0) {
+        return;
     }
+    states.texture = &TextureAtlas::getInstance().getTexture(m_batchPage);
+    target.draw(m_spriteBatch, states);
+    m_spriteBatch.clear();
+    m_drawCalls++;
 }
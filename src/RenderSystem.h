@@ -2,12 +2,15 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <memory>
+#include "SpatialGrid.h"
+#include "RenderSnapshot.h"
+#include "RenderQueue.h"
 
 class Entity;
+class DebugDraw;
+class ParticleSystem;
 class TransformComponent;
 class VisualComponent;
-class CollisionComponent;
-class DirectionComponent;
 
 class RenderSystem
 {
@@ -15,12 +18,56 @@ public:
     RenderSystem() = default;
     ~RenderSystem() = default;
 
+    // Builds and draws a snapshot in one go, for single threaded rendering
     void draw(sf::RenderTarget &target, sf::RenderStates states,
               const std::vector<std::unique_ptr<Entity>> &entities);
 
+    // Simulation side: culls against the view and records every visible sprite
+    void buildSnapshot(const sf::View &view, const std::vector<std::unique_ptr<Entity>> &entities,
+                       RenderSnapshot &snapshot);
+    // Drawing side: only reads the snapshot and the batch, never entities or culling state, so
+    // it may run on a render thread while the next snapshot is being built
+    void drawSnapshot(sf::RenderTarget &target, sf::RenderStates states,
+                      const RenderSnapshot &snapshot);
+
+    // Sprites drawn / skipped by view culling in the last snapshot
+    size_t getVisibleCount() const { return m_visibleCount; }
+    size_t getCulledCount() const { return m_culledCount; }
+    // Sprite batches drawn / atlas page switches in the last drawSnapshot
+    size_t getDrawCallCount() const { return m_drawCalls; }
+    size_t getTextureChangeCount() const { return m_textureChanges; }
+
+    void setDebugDraw(const DebugDraw *debugDraw) { m_debugDraw = debugDraw; }
+    void setParticleSystem(const ParticleSystem *particles) { m_particles = particles; }
+
 private:
-    void prepareEntity(VisualComponent *visual, CollisionComponent *collision,
-                       DirectionComponent *dir) const;
-    void drawEntity(sf::RenderTarget &target, sf::RenderStates states, VisualComponent *visual,
-                    CollisionComponent *collision) const;
+    struct Drawn
+    {
+        VisualComponent *visual;
+        const TransformComponent *transform;
+    };
+
+    void cull(const sf::View &view, const std::vector<std::unique_ptr<Entity>> &entities);
+    void appendInstance(const RenderInstance &instance);
+    void flushBatch(sf::RenderTarget &target, sf::RenderStates states);
+
+    // Drawing side: sprites in sort key order, batched while they share an atlas page
+    RenderQueue m_queue;
+    sf::VertexArray m_spriteBatch{sf::Triangles};
+    // No page bound yet, so the first sprite of a frame always counts as a page change
+    static constexpr uint32_t NO_PAGE = ~uint32_t(0);
+    uint32_t m_batchPage{NO_PAGE};
+    size_t m_drawCalls{0};
+    size_t m_textureChanges{0};
+
+    // Simulation side: sprite bounds are indexed every frame and queried with the view rectangle
+    SpatialGrid m_visibilityGrid{256.f};
+    std::vector<Drawn> m_drawables;
+    std::vector<size_t> m_visible;
+    size_t m_visibleCount{0};
+    size_t m_culledCount{0};
+
+    const DebugDraw *m_debugDraw{nullptr};
+    const ParticleSystem *m_particles{nullptr};
+    RenderSnapshot m_snapshot;
 };
@@ -0,0 +1,80 @@
+#include "RenderThread.h"
+#include "Game.h"
+#include "Profiler.h"
+
+RenderThread::RenderThread(sf::RenderWindow &window, const Game &game)
+    : m_window(window)
+    , m_game(game)
+{}
+
+RenderThread::~RenderThread()
+{
+    stop();
+}
+
+void RenderThread::start()
+{
+    if (isRunning()) {
+        return;
+    }
+    m_stopping = false;
+    m_hasReady = false;
+
+    // The GL context can only be active on one thread at a time
+    m_window.setActive(false);
+    m_thread = std::thread(&RenderThread::run, this);
+}
+
+void RenderThread::stop()
+{
+    if (!isRunning()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+
+    m_window.setActive(true);
+}
+
+void RenderThread::publish()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    // Wait for the render thread to take the previous snapshot
+    m_condition.wait(lock, [this] { return !m_hasReady || m_stopping; });
+
+    std::swap(m_writeSlot, m_readySlot);
+    m_hasReady = true;
+    lock.unlock();
+    m_condition.notify_all();
+}
+
+void RenderThread::run()
+{
+    PROFILE_THREAD_NAME("render");
+    m_window.setActive(true);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_hasReady || m_stopping; });
+            if (m_stopping) {
+                break;
+            }
+            std::swap(m_drawSlot, m_readySlot);
+            m_hasReady = false;
+        }
+        m_condition.notify_all();
+
+        PROFILE_SCOPE("RenderThread::frame");
+        m_window.clear(sf::Color::Black);
+        m_game.drawSnapshot(m_window, m_slots[m_drawSlot]);
+        PROFILE_SCOPE("display");
+        m_window.display();
+    }
+
+    m_window.setActive(false);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "RenderSnapshot.h"
+
+class Game;
+
+// Draws published snapshots on a dedicated thread, so the simulation of frame N+1 overlaps
+// with drawing and presenting frame N.
+//
+// Three snapshot slots rotate between the simulation (writing), the hand-off (ready) and the
+// render thread (drawing). The simulation runs at most one frame ahead: publish() waits until
+// the previous snapshot has been picked up, which keeps the window's frame limit pacing both.
+class RenderThread
+{
+public:
+    RenderThread(sf::RenderWindow &window, const Game &game);
+    ~RenderThread();
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    // Snapshot owned by the simulation until the next publish()
+    RenderSnapshot &acquire() { return m_slots[m_writeSlot]; }
+    void publish();
+
+private:
+    void run();
+
+    sf::RenderWindow &m_window;
+    const Game &m_game;
+
+    std::array<RenderSnapshot, 3> m_slots;
+    size_t m_writeSlot{0};
+    size_t m_readySlot{1};
+    size_t m_drawSlot{2};
+    bool m_hasReady{false};
+    bool m_stopping{false};
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_thread;
+};
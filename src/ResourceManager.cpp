@@ -1,6 +1,18 @@
 #include "ResourceManager.h"
+#include "AssetPack.h"
 
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
 #include <algorithm>
+#include <filesystem>
+
+namespace {
+    AssetPack &getPack()
+    {
+        static AssetPack pack;
+        return pack;
+    }
+} // namespace
 
 void ResourceManager::init(std::string executablePath)
 {
@@ -8,10 +20,48 @@ void ResourceManager::init(std::string executablePath)
     size_t lastSlashIndex = executablePath.find_last_of('/');
     if (lastSlashIndex != std::string::npos)
         m_assetPath = executablePath.substr(0, lastSlashIndex + 1);
+    m_packPath = m_assetPath + "assets.pack";
     m_assetPath += +"assets/";
+
+    if (std::filesystem::exists(m_packPath)) {
+        openPack(m_packPath);
+    }
 }
 
 std::string ResourceManager::getFilePath(const std::string &fileName)
 {
     return m_assetPath + fileName;
 }
+
+bool ResourceManager::loadImage(const std::string &fileName, sf::Image &image)
+{
+    const AssetPack &pack = getPack();
+    if (const AssetPack::Entry *entry = pack.isOpen() ? pack.find(fileName) : nullptr) {
+        if (entry->kind == AssetPack::Kind::Pixels) {
+            image.create(entry->width, entry->height, pack.getData(*entry));
+            return true;
+        }
+        return image.loadFromMemory(pack.getData(*entry), entry->dataSize);
+    }
+    return image.loadFromFile(getFilePath(fileName));
+}
+
+bool ResourceManager::loadFont(const std::string &fileName, sf::Font &font)
+{
+    const AssetPack &pack = getPack();
+    if (const AssetPack::Entry *entry = pack.isOpen() ? pack.find(fileName) : nullptr) {
+        return font.loadFromMemory(pack.getData(*entry), entry->dataSize);
+    }
+    return font.loadFromFile(getFilePath(fileName));
+}
+
+bool ResourceManager::openPack(const std::string &path)
+{
+    m_packPath = path;
+    return getPack().open(path);
+}
+
+bool ResourceManager::hasPack()
+{
+    return getPack().isOpen();
+}
@@ -2,12 +2,29 @@
 
 #include <string>
 
+namespace sf {
+    class Font;
+    class Image;
+} // namespace sf
+
 class ResourceManager
 {
 public:
+    // Also opens assets.pack next to the executable when there is one
     static void init(std::string executablePath);
     static std::string getFilePath(const std::string &fileName);
 
+    // Assets are served from the pack when it has them, from the loose files otherwise.
+    // Fonts read from the pack point into its mapping, which stays open for the whole run.
+    static bool loadImage(const std::string &fileName, sf::Image &image);
+    static bool loadFont(const std::string &fileName, sf::Font &font);
+
+    // Replaces the open pack, false if path is not a valid pack
+    static bool openPack(const std::string &path);
+    static bool hasPack();
+    static std::string getPackPath() { return m_packPath; }
+
 private:
     static inline std::string m_assetPath;
+    static inline std::string m_packPath;
 };
@@ -0,0 +1,229 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    bool isFinite(const sf::FloatRect &bounds)
+    {
+        return std::isfinite(bounds.left) && std::isfinite(bounds.top) &&
+               std::isfinite(bounds.width) && std::isfinite(bounds.height);
+    }
+
+    float minLeft(const sf::FloatRect &bounds)
+    {
+        return std::min(bounds.left, bounds.left + bounds.width);
+    }
+
+    float minTop(const sf::FloatRect &bounds)
+    {
+        return std::min(bounds.top, bounds.top + bounds.height);
+    }
+} // namespace
+
+void SpatialGrid::clear()
+{
+    m_entries.clear();
+    m_items.clear();
+    m_oversized.clear();
+    m_moved.clear();
+    m_itemCount = 0;
+    m_sorted = true;
+}
+
+int32_t SpatialGrid::toCell(float coordinate) const
+{
+    // Keep inf / NaN bounds from producing absurd cell ranges
+    constexpr float limit = 1 << 30;
+    float cell = std::floor(coordinate / m_cellSize);
+    if (!(cell > -limit))
+        return -(1 << 30);
+    if (!(cell < limit))
+        return 1 << 30;
+    return static_cast<int32_t>(cell);
+}
+
+SpatialGrid::CellRange SpatialGrid::toCells(const sf::FloatRect &bounds) const
+{
+    const float right = bounds.left + bounds.width;
+    const float bottom = bounds.top + bounds.height;
+    return {toCell(minLeft(bounds)), toCell(minTop(bounds)), toCell(std::max(bounds.left, right)),
+            toCell(std::max(bounds.top, bottom))};
+}
+
+void SpatialGrid::insert(size_t index, const sf::FloatRect &bounds)
+{
+    if (index >= m_bounds.size()) {
+        m_bounds.resize(index + 1);
+        m_stamps.resize(index + 1, 0);
+        m_ranges.resize(index + 1);
+        m_placements.resize(index + 1, InCells);
+    }
+    m_bounds[index] = bounds;
+    m_itemCount++;
+    place(index);
+}
+
+void SpatialGrid::place(size_t index)
+{
+    const sf::FloatRect &bounds = m_bounds[index];
+    const CellRange range = toCells(bounds);
+
+    int64_t cellCount = (static_cast<int64_t>(range.x1) - range.x0 + 1) *
+                        (static_cast<int64_t>(range.y1) - range.y0 + 1);
+    if (!isFinite(bounds) || cellCount > MAX_CELLS_PER_ITEM) {
+        m_placements[index] = Oversized;
+        m_oversized.push_back(static_cast<uint32_t>(index));
+        return;
+    }
+
+    m_placements[index] = InCells;
+    m_ranges[index] = range;
+    m_items.push_back(static_cast<uint32_t>(index));
+    for (int32_t y = range.y0; y <= range.y1; y++) {
+        for (int32_t x = range.x0; x <= range.x1; x++) {
+            m_entries.push_back({cellKey(x, y), static_cast<uint32_t>(index)});
+        }
+    }
+    m_sorted = false;
+}
+
+void SpatialGrid::update(size_t index, const sf::FloatRect &bounds)
+{
+    m_bounds[index] = bounds;
+    // Oversized and moved items are already tested linearly with whatever bounds they have
+    if (m_placements[index] != InCells ||
+        (isFinite(bounds) && toCells(bounds) == m_ranges[index])) {
+        return;
+    }
+    m_placements[index] = Moved;
+    m_moved.push_back(static_cast<uint32_t>(index));
+    if (m_moved.size() > MAX_MOVED_ITEMS) {
+        rebucketMoved();
+    }
+}
+
+void SpatialGrid::rebucketMoved()
+{
+    if (m_moved.empty()) {
+        return;
+    }
+    auto isMoved = [this](uint32_t index) { return m_placements[index] == Moved; };
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                   [&](const Entry &entry) { return isMoved(entry.index); }),
+                    m_entries.end());
+    m_items.erase(std::remove_if(m_items.begin(), m_items.end(), isMoved), m_items.end());
+    for (uint32_t index : m_moved) {
+        place(index);
+    }
+    m_moved.clear();
+}
+
+void SpatialGrid::build()
+{
+    if (m_sorted) {
+        return;
+    }
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry &a, const Entry &b) {
+        return a.cell < b.cell || (a.cell == b.cell && a.index < b.index);
+    });
+    m_sorted = true;
+}
+
+void SpatialGrid::query(const sf::FloatRect &area, std::vector<size_t> &out)
+{
+    build();
+    out.clear();
+
+    if (++m_stamp == 0) {
+        std::fill(m_stamps.begin(), m_stamps.end(), 0);
+        m_stamp = 1;
+    }
+
+    auto visit = [&](uint32_t index) {
+        if (m_stamps[index] == m_stamp) {
+            return;
+        }
+        m_stamps[index] = m_stamp;
+        if (area.intersects(m_bounds[index])) {
+            out.push_back(index);
+        }
+    };
+
+    if (!m_entries.empty()) {
+        const CellRange range = toCells(area);
+        // Only walk the rows that have anything in them
+        int32_t y0 = std::max(range.y0, cellY(m_entries.front().cell));
+        int32_t y1 = std::min(range.y1, cellY(m_entries.back().cell));
+
+        for (int32_t y = y0; y <= y1; y++) {
+            const uint64_t rowEnd = cellKey(range.x1, y);
+            auto it = std::lower_bound(
+                m_entries.begin(), m_entries.end(), cellKey(range.x0, y),
+                [](const Entry &entry, uint64_t key) { return entry.cell < key; });
+            for (; it != m_entries.end() && it->cell <= rowEnd; ++it) {
+                visit(it->index);
+            }
+        }
+    }
+    // Moved items may also be visited above through their stale cells, the stamp keeps them
+    // from being reported twice
+    for (uint32_t index : m_oversized) {
+        visit(index);
+    }
+    for (uint32_t index : m_moved) {
+        visit(index);
+    }
+
+    std::sort(out.begin(), out.end());
+}
+
+void SpatialGrid::queryPairs(std::vector<std::pair<size_t, size_t>> &out)
+{
+    rebucketMoved();
+    build();
+    out.clear();
+
+    for (size_t begin = 0; begin < m_entries.size();) {
+        const uint64_t cell = m_entries[begin].cell;
+        size_t end = begin + 1;
+        while (end < m_entries.size() && m_entries[end].cell == cell) end++;
+
+        for (size_t a = begin; a < end; a++) {
+            const uint32_t i = m_entries[a].index;
+            const sf::FloatRect &boundsA = m_bounds[i];
+            for (size_t b = a + 1; b < end; b++) {
+                const uint32_t j = m_entries[b].index;
+                const sf::FloatRect &boundsB = m_bounds[j];
+                if (!boundsA.intersects(boundsB)) {
+                    continue;
+                }
+                // A pair sharing several cells is only reported by the cell holding the
+                // top-left corner of the overlap
+                int32_t ownerX = toCell(std::max(minLeft(boundsA), minLeft(boundsB)));
+                int32_t ownerY = toCell(std::max(minTop(boundsA), minTop(boundsB)));
+                if (cellKey(ownerX, ownerY) == cell) {
+                    out.emplace_back(i, j);
+                }
+            }
+        }
+        begin = end;
+    }
+
+    for (size_t o = 0; o < m_oversized.size(); o++) {
+        const uint32_t i = m_oversized[o];
+        for (uint32_t j : m_items) {
+            if (m_bounds[i].intersects(m_bounds[j])) {
+                out.emplace_back(std::min(i, j), std::max(i, j));
+            }
+        }
+        for (size_t p = o + 1; p < m_oversized.size(); p++) {
+            const uint32_t j = m_oversized[p];
+            if (m_bounds[i].intersects(m_bounds[j])) {
+                out.emplace_back(std::min(i, j), std::max(i, j));
+            }
+        }
+    }
+
+    std::sort(out.begin(), out.end());
+}
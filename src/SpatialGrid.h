@@ -0,0 +1,111 @@
+#pragma once
+#include <SFML/Graphics/Rect.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Uniform grid over world space, rebuilt every frame from item bounds.
+// Cells are kept as runs of a sorted entry list, so rebuilding does not allocate once warm
+// and the world has no fixed extent.
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(float cellSize = 128.f)
+        : m_cellSize(cellSize)
+    {}
+
+    void clear();
+    void insert(size_t index, const sf::FloatRect &bounds);
+    // Moves an item inserted since the last clear. Until enough items have moved to be worth
+    // re-bucketing, one whose cells changed is tested linearly like an oversized one.
+    void update(size_t index, const sf::FloatRect &bounds);
+
+    // Indices whose bounds overlap area, each reported once and in ascending order. An index is
+    // reported exactly when area.intersects(its bounds) holds.
+    void query(const sf::FloatRect &area, std::vector<size_t> &out);
+    // Pairs (i < j) with overlapping bounds, each reported once and in ascending order
+    void queryPairs(std::vector<std::pair<size_t, size_t>> &out);
+
+    float getCellSize() const { return m_cellSize; }
+    size_t getItemCount() const { return m_itemCount; }
+
+    // Calls fn(cellRect, itemCount) for every occupied cell
+    template <typename Fn> void forEachCell(Fn &&fn)
+    {
+        rebucketMoved();
+        build();
+        for (size_t begin = 0; begin < m_entries.size();) {
+            size_t end = begin + 1;
+            while (end < m_entries.size() && m_entries[end].cell == m_entries[begin].cell) end++;
+            sf::FloatRect rect(cellX(m_entries[begin].cell) * m_cellSize,
+                               cellY(m_entries[begin].cell) * m_cellSize, m_cellSize, m_cellSize);
+            fn(rect, end - begin);
+            begin = end;
+        }
+    }
+
+    // Items spanning more cells than this are kept in a separate list and tested linearly
+    static constexpr int MAX_CELLS_PER_ITEM = 1024;
+    // Moved items tested linearly before they are put back into the cells they now cover
+    static constexpr size_t MAX_MOVED_ITEMS = 64;
+
+private:
+    struct Entry
+    {
+        uint64_t cell;
+        uint32_t index;
+    };
+
+    // Inclusive cell range, from the smaller to the larger edge so negative sizes are covered
+    struct CellRange
+    {
+        int32_t x0, y0, x1, y1;
+
+        bool operator==(const CellRange &other) const
+        {
+            return x0 == other.x0 && y0 == other.y0 && x1 == other.x1 && y1 == other.y1;
+        }
+    };
+
+    enum Placement : uint8_t
+    {
+        InCells,
+        Oversized, // or with NaN / inf bounds, which no cell range covers reliably
+        Moved,
+    };
+
+    static uint64_t cellKey(int32_t x, int32_t y)
+    {
+        // Row-major ordering: y in the high bits
+        return (static_cast<uint64_t>(static_cast<uint32_t>(y) ^ 0x80000000u) << 32) |
+               (static_cast<uint32_t>(x) ^ 0x80000000u);
+    }
+    static int32_t cellX(uint64_t key)
+    {
+        return static_cast<int32_t>(static_cast<uint32_t>(key) ^ 0x80000000u);
+    }
+    static int32_t cellY(uint64_t key)
+    {
+        return static_cast<int32_t>(static_cast<uint32_t>(key >> 32) ^ 0x80000000u);
+    }
+    int32_t toCell(float coordinate) const;
+    CellRange toCells(const sf::FloatRect &bounds) const;
+    // Buckets index by its current bounds
+    void place(size_t index);
+    // Drops the stale entries of moved items and buckets them again
+    void rebucketMoved();
+    void build();
+
+    float m_cellSize;
+    bool m_sorted{true};
+    size_t m_itemCount{0};
+    std::vector<Entry> m_entries;
+    std::vector<sf::FloatRect> m_bounds;
+    std::vector<uint32_t> m_items;
+    std::vector<uint32_t> m_oversized;
+    std::vector<uint32_t> m_moved;
+    std::vector<CellRange> m_ranges;
+    std::vector<Placement> m_placements;
+    std::vector<uint32_t> m_stamps;
+    uint32_t m_stamp{0};
+};
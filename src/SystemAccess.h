@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <typeinfo>
+
+// Component and shared state types a system reads or writes, one bit per type
+using AccessMask = uint64_t;
+
+namespace AccessBits {
+    inline std::atomic<uint32_t> nextBit{0};
+} // namespace AccessBits
+
+// Bit of T in an AccessMask, assigned on first use. T is a component or any other state systems
+// share, e.g. ParticleSystem or DebugDraw.
+template <typename T> AccessMask accessBit()
+{
+    static const AccessMask bit = [] {
+        const uint32_t index = AccessBits::nextBit++;
+        assert(index < 64 && "more access types than an AccessMask holds");
+        return AccessMask(1) << index;
+    }();
+    return bit;
+}
+
+// What a system touches, declared when it is added to the SystemScheduler
+struct SystemAccess
+{
+    AccessMask reads{0};
+    AccessMask writes{0};
+
+    template <typename T> SystemAccess &read()
+    {
+        reads |= accessBit<T>();
+        return *this;
+    }
+
+    template <typename T> SystemAccess &write()
+    {
+        writes |= accessBit<T>();
+        return *this;
+    }
+
+    // Conflicting systems keep their order, the others may run at the same time
+    bool conflictsWith(const SystemAccess &other) const
+    {
+        return (writes & (other.reads | other.writes)) != 0 || (reads & other.writes) != 0;
+    }
+};
+
+// Debug builds check every component lookup made while a scheduled system runs against what the
+// system declared, see SystemScheduler. Lookups through a const container are reads, the others
+// may write.
+#ifdef SURVIVE_CHECK_SYSTEM_ACCESS
+namespace AccessCheck {
+    struct Scope
+    {
+        const char *system;
+        AccessMask reads;
+        AccessMask writes;
+    };
+
+    inline thread_local const Scope *t_scope = nullptr;
+
+    // Reported once per system, type and kind of access
+    void reportUndeclared(const Scope &scope, AccessMask bit, const char *typeName, bool write);
+
+    template <typename T> void check(bool write)
+    {
+        if (!t_scope) {
+            return;
+        }
+        const AccessMask bit = accessBit<T>();
+        if (write && (t_scope->writes & bit) == 0) {
+            reportUndeclared(*t_scope, bit, typeid(T).name(), true);
+            // The graph lets systems that only read T run next to this one
+            assert(!"a scheduled system wrote a type it did not declare as written");
+        }
+        else if (!write && ((t_scope->reads | t_scope->writes) & bit) == 0) {
+            reportUndeclared(*t_scope, bit, typeid(T).name(), false);
+        }
+    }
+} // namespace AccessCheck
+
+#define SURVIVE_CHECK_READ(T) AccessCheck::check<T>(false)
+#define SURVIVE_CHECK_WRITE(T) AccessCheck::check<T>(true)
+#else
+#define SURVIVE_CHECK_READ(T) ((void)0)
+#define SURVIVE_CHECK_WRITE(T) ((void)0)
+#endif
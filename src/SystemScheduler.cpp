@@ -0,0 +1,153 @@
+#include "SystemScheduler.h"
+#include "Profiler.h"
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <utility>
+
+#ifdef SURVIVE_CHECK_SYSTEM_ACCESS
+void AccessCheck::reportUndeclared(const Scope &scope, AccessMask bit, const char *typeName,
+                                   bool write)
+{
+    static std::mutex mutex;
+    static std::set<std::tuple<const char *, AccessMask, bool>> reported;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (reported.insert({scope.system, bit, write}).second) {
+        std::cerr << "System " << scope.system << (write ? " writes " : " uses ") << typeName
+                  << (write ? " without declaring it as written" : " without declaring it")
+                  << std::endl;
+    }
+}
+#endif
+
+size_t SystemScheduler::addSystem(const std::string &name, const SystemAccess &access,
+                                  Update update)
+{
+    System system;
+    system.name = name;
+    system.profileName = Profiler::getInstance().intern(name);
+    system.access = access;
+    system.update = std::move(update);
+    m_systems.push_back(std::move(system));
+    m_graphBuilt = false;
+    return m_systems.size() - 1;
+}
+
+void SystemScheduler::buildGraph()
+{
+    for (System &system : m_systems) {
+        system.dependencies.clear();
+        system.successors.clear();
+    }
+    for (size_t later = 0; later < m_systems.size(); later++) {
+        for (size_t earlier = 0; earlier < later; earlier++) {
+            if (m_systems[later].access.conflictsWith(m_systems[earlier].access)) {
+                m_systems[later].dependencies.push_back(earlier);
+                m_systems[earlier].successors.push_back(later);
+            }
+        }
+    }
+    m_remaining = std::vector<std::atomic<uint32_t>>(m_systems.size());
+    m_graphBuilt = true;
+}
+
+void SystemScheduler::run(float deltaTime, JobSystem &jobs)
+{
+    if (!m_graphBuilt) {
+        buildGraph();
+    }
+    for (size_t i = 0; i < m_systems.size(); i++) {
+        m_remaining[i].store(static_cast<uint32_t>(m_systems[i].dependencies.size()));
+    }
+
+    JobCounter done;
+    for (size_t i = 0; i < m_systems.size(); i++) {
+        if (m_systems[i].dependencies.empty()) {
+            jobs.run([this, i, deltaTime, &jobs, &done] {
+                executeAndRelease(i, deltaTime, jobs, done);
+            }, &done);
+        }
+    }
+    jobs.wait(done);
+}
+
+void SystemScheduler::runSerial(float deltaTime)
+{
+    for (size_t i = 0; i < m_systems.size(); i++) {
+        execute(i, deltaTime);
+    }
+}
+
+void SystemScheduler::executeAndRelease(size_t index, float deltaTime, JobSystem &jobs,
+                                        JobCounter &done)
+{
+    execute(index, deltaTime);
+
+    // The last dependency to finish starts the successor. It is queued against done before
+    // this job finishes, so done cannot reach zero early.
+    for (size_t successor : m_systems[index].successors) {
+        if (m_remaining[successor].fetch_sub(1) == 1) {
+            jobs.run([this, successor, deltaTime, &jobs, &done] {
+                executeAndRelease(successor, deltaTime, jobs, done);
+            }, &done);
+        }
+    }
+}
+
+void SystemScheduler::execute(size_t index, float deltaTime)
+{
+    System &system = m_systems[index];
+    PROFILE_SCOPE(system.profileName);
+    // Read on the thread that runs the system, so the difference is only this system
+    PerfCounters &perf = PerfCounters::getInstance();
+    PerfCounters::Sample countersBefore;
+    perf.read(countersBefore);
+    system.lastAllocations = {};
+    AllocTracker::Scope allocations(system.lastAllocations);
+    auto start = std::chrono::steady_clock::now();
+#ifdef SURVIVE_CHECK_SYSTEM_ACCESS
+    const AccessCheck::Scope scope{system.name.c_str(), system.access.reads, system.access.writes};
+    const AccessCheck::Scope *previous = AccessCheck::t_scope;
+    AccessCheck::t_scope = &scope;
+    system.update(deltaTime);
+    AccessCheck::t_scope = previous;
+#else
+    system.update(deltaTime);
+#endif
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    system.lastMs = elapsed.count();
+
+    PerfCounters::Sample countersAfter;
+    perf.read(countersAfter);
+    system.lastCounters = countersAfter - countersBefore;
+    if (system.lastCounters.valid) {
+        PROFILE_COUNTERS(system.profileName, system.lastCounters.values.data(),
+                         PerfCounters::getNames().data(), PerfCounters::COUNT,
+                         system.lastCounters.available);
+    }
+}
+
+void SystemScheduler::printGraph(std::ostream &out)
+{
+    if (!m_graphBuilt) {
+        buildGraph();
+    }
+    for (const System &system : m_systems) {
+        out << "  " << system.name;
+        if (system.dependencies.empty()) {
+            out << " (no dependencies)";
+        }
+        else {
+            out << " after";
+            for (size_t dependency : system.dependencies) {
+                out << " " << m_systems[dependency].name;
+            }
+        }
+        out << "\n";
+    }
+    out.flush();
+}
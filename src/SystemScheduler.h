@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "AllocTracker.h"
+#include "JobSystem.h"
+#include "PerfCounters.h"
+#include "SystemAccess.h"
+
+// Runs the per-tick systems as a dependency graph. Every system declares the types it reads
+// and writes; a system depends on every earlier one it conflicts with, so the result matches
+// running them one after the other in the order they were added, while systems touching
+// disjoint data run at the same time on the job system.
+//
+// Debug builds (SURVIVE_CHECK_SYSTEM_ACCESS) report component lookups a system did not declare
+// and assert when a system looks up a type it only declared as read through a non-const entity.
+class SystemScheduler
+{
+public:
+    using Update = std::function<void(float deltaTime)>;
+
+    SystemScheduler() = default;
+    SystemScheduler(const SystemScheduler &) = delete;
+    SystemScheduler &operator=(const SystemScheduler &) = delete;
+
+    size_t addSystem(const std::string &name, const SystemAccess &access, Update update);
+
+    // Runs every system once, independent ones in parallel, and returns when all are done
+    void run(float deltaTime, JobSystem &jobs);
+    // Same systems, in the order they were added, on the calling thread
+    void runSerial(float deltaTime);
+
+    size_t getSystemCount() const { return m_systems.size(); }
+    const std::string &getSystemName(size_t index) const { return m_systems[index].name; }
+    // Wall time of the system in the last run, measured on whichever thread ran it
+    double getLastDurationMs(size_t index) const { return m_systems[index].lastMs; }
+    // Heap allocations the system made on its own thread in the last run, counted in builds
+    // with SURVIVE_TRACK_ALLOCATIONS
+    const AllocCounts &getLastAllocations(size_t index) const
+    {
+        return m_systems[index].lastAllocations;
+    }
+    // Hardware counters of the system in the last run, invalid unless PerfCounters is enabled
+    // and supported
+    const PerfCounters::Sample &getLastCounters(size_t index) const
+    {
+        return m_systems[index].lastCounters;
+    }
+    // Each system with the ones it waits for
+    void printGraph(std::ostream &out);
+
+private:
+    struct System
+    {
+        std::string name;
+        const char *profileName{nullptr}; // interned, outlives the system list
+        SystemAccess access;
+        Update update;
+        std::vector<size_t> dependencies;
+        std::vector<size_t> successors;
+        double lastMs{0.0}; // only written by the job running the system
+        PerfCounters::Sample lastCounters;
+        AllocCounts lastAllocations;
+    };
+
+    void buildGraph();
+    void execute(size_t index, float deltaTime);
+    void executeAndRelease(size_t index, float deltaTime, JobSystem &jobs, JobCounter &done);
+
+    std::vector<System> m_systems;
+    std::vector<std::atomic<uint32_t>> m_remaining; // unfinished dependencies, this run
+    bool m_graphBuilt{false};
+};
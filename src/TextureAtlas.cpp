@@ -0,0 +1,135 @@
+#include "TextureAtlas.h"
+#include "AssetPreloader.h"
+#include "Config/EntityManager.h"
+
+#include <algorithm>
+#include <iostream>
+
+void TextureAtlas::build()
+{
+    if (m_built) {
+        return;
+    }
+
+    AssetPreloader preloader;
+    preloader.start(AssetManifest::fromConfigs(EntityManager::getInstance().getConfigs()));
+    preloader.wait();
+    build(preloader.getAssets());
+}
+
+void TextureAtlas::build(const std::vector<LoadedAsset> &assets)
+{
+    if (m_built) {
+        return;
+    }
+
+    // Decoded images are packed straight from the assets, only stand-ins are created here
+    std::vector<sf::Image> standIns;
+    standIns.reserve(assets.size() + 1);
+    std::vector<std::pair<std::string, const sf::Image *>> images;
+    images.reserve(assets.size() + 1);
+    for (const LoadedAsset &asset : assets) {
+        if (asset.entry.kind != AssetEntry::Kind::Texture) {
+            continue;
+        }
+        if (asset.loaded) {
+            images.emplace_back(asset.entry.filename, &asset.image);
+            continue;
+        }
+        std::cerr << "Unable to load texture " << asset.entry.filename
+                  << ", using a blank region" << std::endl;
+        sf::Image &image = standIns.emplace_back();
+        image.create(std::max(asset.entry.extent.x, 1u), std::max(asset.entry.extent.y, 1u),
+                     sf::Color::White);
+        images.emplace_back(asset.entry.filename, &image);
+    }
+
+    sf::Image &white = standIns.emplace_back();
+    white.create(1, 1, sf::Color::White);
+    images.emplace_back(std::string(), &white);
+
+    // Tallest first keeps the shelves tight
+    std::sort(images.begin(), images.end(), [](const auto &a, const auto &b) {
+        return a.second->getSize().y > b.second->getSize().y;
+    });
+
+    for (const auto &[filename, image] : images) {
+        AtlasRegion region = pack(*image);
+        if (filename.empty())
+            m_whiteRegion = region;
+        else
+            m_regions[filename] = region;
+    }
+
+    // Trim every page down to the rows that were actually used
+    for (auto &page : m_pages) {
+        unsigned usedHeight = page.shelfY + page.shelfHeight;
+        if (usedHeight < page.image.getSize().y) {
+            sf::Image trimmed;
+            trimmed.create(page.image.getSize().x, usedHeight, sf::Color::Transparent);
+            trimmed.copy(page.image, 0, 0,
+                         sf::IntRect(0, 0, page.image.getSize().x, usedHeight));
+            page.image = std::move(trimmed);
+        }
+    }
+
+    m_built = true;
+}
+
+AtlasRegion TextureAtlas::pack(const sf::Image &image)
+{
+    const sf::Vector2u size = image.getSize();
+    const unsigned width = size.x + PADDING;
+    const unsigned height = size.y + PADDING;
+
+    auto newPage = [this](unsigned pageWidth, unsigned pageHeight) -> Page & {
+        Page &page = m_pages.emplace_back();
+        page.image.create(pageWidth, pageHeight, sf::Color::Transparent);
+        page.texture = std::make_unique<sf::Texture>();
+        return page;
+    };
+
+    // Oversized sheets get a page of their own
+    if (width > PAGE_SIZE || height > PAGE_SIZE) {
+        Page &page = newPage(size.x, size.y);
+        page.image.copy(image, 0, 0);
+        page.shelfHeight = size.y;
+        page.shelfX = PAGE_SIZE;
+        return {m_pages.size() - 1, sf::IntRect(0, 0, size.x, size.y)};
+    }
+
+    Page *page = m_pages.empty() ? nullptr : &m_pages.back();
+    if (page && page->shelfX + width > page->image.getSize().x) {
+        // start the next shelf
+        page->shelfY += page->shelfHeight;
+        page->shelfX = 0;
+        page->shelfHeight = 0;
+    }
+    if (!page || page->shelfY + height > page->image.getSize().y) {
+        page = &newPage(PAGE_SIZE, PAGE_SIZE);
+    }
+
+    sf::IntRect rect(page->shelfX, page->shelfY, size.x, size.y);
+    page->image.copy(image, rect.left, rect.top);
+    page->shelfX += width;
+    page->shelfHeight = std::max(page->shelfHeight, height);
+
+    return {m_pages.size() - 1, rect};
+}
+
+bool TextureAtlas::upload()
+{
+    build();
+    for (auto &page : m_pages) {
+        if (!page.texture->loadFromImage(page.image)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const AtlasRegion &TextureAtlas::getRegion(const std::string &filename) const
+{
+    auto it = m_regions.find(filename);
+    return it != m_regions.end() ? it->second : m_whiteRegion;
+}
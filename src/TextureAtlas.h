@@ -0,0 +1,72 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct LoadedAsset;
+
+struct AtlasRegion
+{
+    size_t page{0};
+    sf::IntRect rect;
+};
+
+// Packs every sprite sheet referenced by the entity configs into as few textures as possible
+// at startup, so sprites of different entity types can be drawn in the same batch.
+class TextureAtlas
+{
+public:
+    static TextureAtlas &getInstance()
+    {
+        static TextureAtlas instance;
+        return instance;
+    }
+
+    // Decodes every sheet the entity configs reference on worker threads and packs them on the
+    // CPU, safe to call more than once
+    void build();
+    // Packs sheets that are already decoded, e.g. by the startup AssetPreloader. Textures that
+    // failed to load get a blank region of the size their animations expect.
+    void build(const std::vector<LoadedAsset> &assets);
+    // Creates the GPU textures for every packed page, needs a GL context
+    bool upload();
+
+    bool isBuilt() const { return m_built; }
+
+    // Region of a sprite sheet inside the atlas, a blank region if the sheet is unknown
+    const AtlasRegion &getRegion(const std::string &filename) const;
+    bool hasRegion(const std::string &filename) const { return m_regions.count(filename) > 0; }
+    // 1x1 opaque white texel for untextured geometry drawn through the sprite batch
+    const AtlasRegion &getWhiteRegion() const { return m_whiteRegion; }
+
+    size_t getPageCount() const { return m_pages.size(); }
+    const sf::Texture &getTexture(size_t page) const { return *m_pages[page].texture; }
+
+    TextureAtlas(const TextureAtlas &) = delete;
+    TextureAtlas &operator=(const TextureAtlas &) = delete;
+
+    static constexpr unsigned PAGE_SIZE = 2048;
+    static constexpr unsigned PADDING = 1;
+
+private:
+    TextureAtlas() = default;
+
+    struct Page
+    {
+        sf::Image image;
+        std::unique_ptr<sf::Texture> texture;
+        unsigned shelfX{0};
+        unsigned shelfY{0};
+        unsigned shelfHeight{0};
+    };
+
+    AtlasRegion pack(const sf::Image &image);
+
+    std::vector<Page> m_pages;
+    std::unordered_map<std::string, AtlasRegion> m_regions;
+    AtlasRegion m_whiteRegion;
+    bool m_built{false};
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 
 enum class GameState
 {
@@ -14,7 +15,8 @@ enum EntityState
     MOVE_RIGHT,
     MOVE_DOWN,
     MOVE_LEFT,
-    WEAPON_1
+    WEAPON_1,
+    ENTITY_STATE_COUNT // number of real states, for arrays indexed by state
 };
 
 enum class EntityType
@@ -28,4 +30,10 @@ enum class EntityType
     TEST_BOX,
     WALL_HORIZONTAL,
     WALL_VERTICAL,
+    COUNT // number of types, for arrays indexed by type
 };
+
+constexpr size_t ENTITY_TYPE_COUNT = static_cast<size_t>(EntityType::COUNT);
+
+// Slot of a type in the arrays indexed by EntityType
+constexpr size_t toIndex(EntityType type) { return static_cast<size_t>(type); }
@@ -0,0 +1,218 @@
+#include "WorldHash.h"
+#include "Entity.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include "Components/AnimationComponent.h"
+#include "Components/CollisionComponent.h"
+#include "Components/DirectionComponent.h"
+#include "Components/HealthComponent.h"
+#include "Components/KinematicsComponent.h"
+#include "Components/TransformComponent.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    // Word at a time, every step multiplies and folds the high bits back down so a change in
+    // any bit reaches the whole state
+    struct Hasher
+    {
+        uint64_t value{0x9e3779b97f4a7c15ull};
+
+        void add(uint64_t word)
+        {
+            value = (value ^ word) * 0xff51afd7ed558ccdull;
+            value ^= value >> 32;
+        }
+
+        void add(float number)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &number, sizeof(bits));
+            add(uint64_t(bits));
+        }
+
+        void add(const sf::Vector2f &vector)
+        {
+            add(vector.x);
+            add(vector.y);
+        }
+
+        // splitmix64 finaliser
+        uint64_t finish() const
+        {
+            uint64_t x = value;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            return x ^ (x >> 31);
+        }
+    };
+
+    constexpr size_t HASH_GRAIN = 256;
+} // namespace
+
+uint64_t WorldHash::hashEntity(const Entity &entity)
+{
+    Hasher hasher;
+    hasher.add(uint64_t(entity.getType()));
+
+    // Which components are there is part of the state too
+    uint64_t present = 0;
+    if (const auto *transform = entity.getComponent<TransformComponent>()) {
+        present |= 1 << 0;
+        hasher.add(transform->position);
+        hasher.add(transform->rotation);
+        hasher.add(transform->scale);
+    }
+    if (const auto *kin = entity.getComponent<KinematicsComponent>()) {
+        present |= 1 << 1;
+        hasher.add(kin->velocity);
+        hasher.add(kin->acceleration);
+        hasher.add(kin->angularVelocity);
+        hasher.add(kin->orbitAngle);
+        hasher.add(kin->currentTime);
+    }
+    if (const auto *health = entity.getComponent<HealthComponent>()) {
+        present |= 1 << 2;
+        hasher.add(health->currentHealth);
+    }
+    if (const auto *direction = entity.getComponent<DirectionComponent>()) {
+        present |= 1 << 3;
+        hasher.add(uint64_t(int64_t(direction->getFacing())));
+    }
+    if (const auto *animation = entity.getComponent<AnimationComponent>()) {
+        present |= 1 << 4;
+        hasher.add(uint64_t(animation->requestedState));
+        hasher.add(uint64_t(animation->currentState));
+        hasher.add(uint64_t(animation->currentFrame));
+        hasher.add(uint64_t(animation->isPlaying));
+    }
+    if (const auto *collision = entity.getComponent<CollisionComponent>()) {
+        present |= 1 << 5;
+        hasher.add(uint64_t(collision->isColliding));
+    }
+    hasher.add(present);
+    return hasher.finish();
+}
+
+uint64_t WorldHash::hashWorld(const std::vector<std::unique_ptr<Entity>> &entities,
+                              std::vector<uint64_t> &entityHashes)
+{
+    entityHashes.resize(entities.size());
+    auto hashRange = [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            entityHashes[i] = hashEntity(*entities[i]);
+        }
+    };
+    JobSystem::getInstance().parallelFor(0, entities.size(), HASH_GRAIN, hashRange);
+
+    Hasher hasher;
+    hasher.add(uint64_t(entities.size()));
+    for (uint64_t hash : entityHashes) {
+        hasher.add(hash);
+    }
+    return hasher.finish();
+}
+
+void WorldHashLog::add(uint64_t worldHash, const std::vector<uint64_t> &entityHashes)
+{
+    Tick tick;
+    std::memset(&tick, 0, sizeof(tick));
+    tick.worldHash = worldHash;
+    tick.firstEntity = m_entityHashes.size();
+    tick.entityCount = static_cast<uint32_t>(entityHashes.size());
+    m_ticks.push_back(tick);
+    for (uint64_t hash : entityHashes) {
+        m_entityHashes.push_back(static_cast<uint32_t>(hash));
+    }
+}
+
+size_t WorldHashLog::findDivergence(size_t tick, uint64_t worldHash,
+                                    const std::vector<uint64_t> &entityHashes) const
+{
+    const Tick &logged = m_ticks[tick];
+    if (logged.worldHash == worldHash && logged.entityCount == entityHashes.size()) {
+        return NO_DIVERGENCE;
+    }
+    const size_t shared = std::min<size_t>(logged.entityCount, entityHashes.size());
+    for (size_t i = 0; i < shared; i++) {
+        if (m_entityHashes[logged.firstEntity + i] != static_cast<uint32_t>(entityHashes[i])) {
+            return i;
+        }
+    }
+    // The first entity only one side has, or a difference in bits the log does not keep
+    return logged.entityCount != entityHashes.size() ? shared : WORLD_HASH_ONLY;
+}
+
+bool WorldHashLog::write(const std::string &path) const
+{
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.endianCheck = ENDIAN_CHECK;
+    header.tickCount = m_ticks.size();
+    header.entityHashCount = m_entityHashes.size();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(m_ticks.data()), m_ticks.size() * sizeof(Tick));
+    file.write(reinterpret_cast<const char *>(m_entityHashes.data()),
+               m_entityHashes.size() * sizeof(uint32_t));
+    if (!file) {
+        std::cerr << "Unable to write world hash log " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool WorldHashLog::read(const std::string &path)
+{
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+
+    auto reject = [&path](const char *reason) {
+        std::cerr << "Unable to read world hash log " << path << ": " << reason << std::endl;
+        return false;
+    };
+
+    if (file.size() < sizeof(Header)) {
+        return reject("truncated");
+    }
+    Header header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.magic != MAGIC) {
+        return reject("not a world hash log");
+    }
+    if (header.endianCheck != ENDIAN_CHECK) {
+        return reject("written on a machine with a different byte order");
+    }
+    if (header.version != VERSION) {
+        return reject("version mismatch, record it again");
+    }
+    const uint64_t body = file.size() - sizeof(Header);
+    if (header.tickCount > body / sizeof(Tick) ||
+        header.entityHashCount * sizeof(uint32_t) != body - header.tickCount * sizeof(Tick)) {
+        return reject("section sizes do not match the file size");
+    }
+
+    std::vector<Tick> ticks(header.tickCount);
+    std::memcpy(ticks.data(), file.data() + sizeof(Header), ticks.size() * sizeof(Tick));
+    for (const Tick &tick : ticks) {
+        if (tick.firstEntity > header.entityHashCount ||
+            tick.entityCount > header.entityHashCount - tick.firstEntity) {
+            return reject("tick out of bounds");
+        }
+    }
+
+    m_ticks = std::move(ticks);
+    m_entityHashes.resize(header.entityHashCount);
+    std::memcpy(m_entityHashes.data(),
+                file.data() + sizeof(Header) + m_ticks.size() * sizeof(Tick),
+                m_entityHashes.size() * sizeof(uint32_t));
+    return true;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Entity;
+
+// 64 bit hash of the simulation state: every entity's type, transform, velocities, health,
+// facing, collision flag and animation state, in entity order. Floats are hashed by their bits,
+// so two runs only match when they computed exactly the same values. Entities are hashed on
+// their own first, a mismatch can then be traced to the first entity that differs.
+//
+// Every tick rehashes every entity rather than updating hashes as components change: nothing
+// tracks which components a system wrote, and a cache that missed one write would hide the
+// very divergence this is looking for. The work is spread over the job system instead.
+class WorldHash
+{
+public:
+    static uint64_t hashEntity(const Entity &entity);
+    // Fills entityHashes with one hash per entity, spread over the job system, and folds them
+    // into the world hash in entity order
+    static uint64_t hashWorld(const std::vector<std::unique_ptr<Entity>> &entities,
+                              std::vector<uint64_t> &entityHashes);
+};
+
+// The world and entity hashes of every tick of a run. Written once as the golden file of a
+// scenario or replay, later runs check each tick against it to find the first tick and entity
+// where they diverge. Entity hashes are kept as their low 32 bits, the world hash in full.
+//
+//   Header | Tick records | Entity hashes
+class WorldHashLog
+{
+public:
+    static constexpr uint32_t MAGIC = 0x48575653; // "SVWH"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t ENDIAN_CHECK = 0x01020304;
+    static constexpr size_t NO_DIVERGENCE = ~size_t(0);
+    // Counts and every logged entity hash match, only bits of the world hash the entity hashes
+    // do not keep differ
+    static constexpr size_t WORLD_HASH_ONLY = NO_DIVERGENCE - 1;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t endianCheck;
+        uint32_t reserved;
+        uint64_t tickCount;
+        uint64_t entityHashCount;
+    };
+
+    struct Tick
+    {
+        uint64_t worldHash;
+        uint64_t firstEntity; // into the entity hashes
+        uint32_t entityCount;
+        uint32_t reserved;
+    };
+
+    void add(uint64_t worldHash, const std::vector<uint64_t> &entityHashes);
+
+    size_t getTickCount() const { return m_ticks.size(); }
+    uint64_t getWorldHash(size_t tick) const { return m_ticks[tick].worldHash; }
+    size_t getEntityCount(size_t tick) const { return m_ticks[tick].entityCount; }
+
+    // First entity whose hash differs from the one logged for tick. When every shared entity
+    // matches but the counts differ, that is the first entity only one side has.
+    // NO_DIVERGENCE when the whole tick matches, WORLD_HASH_ONLY when only the world hash does
+    // not.
+    size_t findDivergence(size_t tick, uint64_t worldHash,
+                          const std::vector<uint64_t> &entityHashes) const;
+
+    bool write(const std::string &path) const;
+    bool read(const std::string &path);
+
+private:
+    std::vector<Tick> m_ticks;
+    std::vector<uint32_t> m_entityHashes;
+};
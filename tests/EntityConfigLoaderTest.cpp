@@ -0,0 +1,54 @@
+// Checks of the entity config text format, run by ctest. Needs neither a window nor the assets.
+//
+//   survive_config_test
+
+#include <iostream>
+#include <sstream>
+
+#include "Config/EntityConfigLoader.h"
+
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const char *what)
+    {
+        if (!condition) {
+            std::cerr << "FAILED: " << what << std::endl;
+            failures++;
+        }
+    }
+
+    // Loads a [TEST_BOX] section with the given collision.debugColor and returns the colour
+    bool loadDebugColor(const char *value, sf::Color &out)
+    {
+        std::istringstream input(std::string("[TEST_BOX]\ncollision.circle = 10\n"
+                                             "collision.debugColor = ") +
+                                 value + "\n");
+        EntityConfigTable configs;
+        if (!EntityConfigLoader::load(input, "test", configs)) {
+            return false;
+        }
+        const auto &config = configs[toIndex(EntityType::TEST_BOX)];
+        if (!config || !config->collision) {
+            return false;
+        }
+        out = config->collision->debugColor;
+        return true;
+    }
+} // namespace
+
+int main()
+{
+    sf::Color color;
+    check(loadDebugColor("255 0 0", color) && color == sf::Color(255, 0, 0, 255),
+          "\"r g b\" colours are opaque");
+    check(loadDebugColor("255 0 0 128", color) && color == sf::Color(255, 0, 0, 128),
+          "\"r g b a\" colours keep their alpha");
+    check(!loadDebugColor("255 0", color), "colours with two components are rejected");
+    check(!loadDebugColor("255 0 0 128 7", color), "colours with five components are rejected");
+
+    if (failures == 0) {
+        std::cout << "All entity config checks passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+// Bundles an assets directory into the pack ResourceManager maps at startup.
+//
+//   survive_assetpack <assets directory> <assets.pack>
+
+#include <iostream>
+
+#include "AssetPack.h"
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <assets directory> <assets.pack>" << std::endl;
+        return 1;
+    }
+
+    if (!AssetPack::write(argv[1], argv[2])) {
+        return 1;
+    }
+
+    AssetPack pack;
+    if (!pack.open(argv[2])) {
+        return 1;
+    }
+    std::cout << "Packed " << pack.getEntryCount() << " assets into " << argv[2] << std::endl;
+    return 0;
+}
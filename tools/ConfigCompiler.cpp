@@ -0,0 +1,46 @@
+// Compiles entity definitions into the binary blob EntityManager maps at startup.
+//
+//   survive_configc <entities.cfg> <entities.bin>
+//   survive_configc --builtin <entities.bin>      compiled-in definitions only
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "Config/ConfigBlob.h"
+#include "Config/EntityConfigLoader.h"
+#include "MappedFile.h"
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <entities.cfg|--builtin> <entities.bin>"
+                  << std::endl;
+        return 1;
+    }
+    const bool builtin = std::strcmp(argv[1], "--builtin") == 0;
+
+    // Same layering as EntityManager: the text overrides the compiled-in types
+    EntityConfigTable configs = Config::copyEntityConfigs();
+
+    uint64_t sourceHash = 0;
+    if (!builtin) {
+        MappedFile text;
+        if (!text.open(argv[1])) {
+            std::cerr << "Unable to open " << argv[1] << std::endl;
+            return 1;
+        }
+        sourceHash = ConfigBlob::hash(text.data(), text.size());
+        if (!EntityConfigLoader::loadFromFile(argv[1], configs)) {
+            return 1;
+        }
+    }
+
+    if (!ConfigBlob::write(argv[2], configs, sourceHash)) {
+        return 1;
+    }
+    const auto count = std::count_if(configs.begin(), configs.end(),
+                                     [](const auto &config) { return config.has_value(); });
+    std::cout << "Wrote " << count << " entity types to " << argv[2] << std::endl;
+    return 0;
+}
@@ -0,0 +1,387 @@
+// Runs the simulation for a fixed number of ticks with a scripted player and no window,
+// for CI boxes and servers without a display.
+//
+//   survive_headless [--ticks N] [--dt SECONDS] [--boxes N] [--wave N] [--seed N]
+//                    [--config PATH] [--replay PATH] [--hash-out PATH] [--hash-check PATH]
+//                    [--trace PATH] [--counters] [--no-alloc-after TICKS] [--collision-sweep]
+//                    [--reload-at TICK]
+//
+// --replay runs a session recorded with `survive --record PATH` as fast as it goes instead of
+// the scripted player, with the recorded seed, frame times and tick count. It cannot be combined
+// with --wave. Headless runs never hot reload the entity config, --reload-at re-reads it once
+// before the given tick and patches every live entity, to time a reload.
+//
+// --hash-out writes the world hash of every tick (see WorldHash) as the golden file of the run,
+// --hash-check compares every tick against one and fails at the first tick that diverges,
+// naming the first entity that differs. Hashing is left out of the timings.
+//
+// --collision-sweep tests every pair of colliders instead of querying the broadphase grid. Both
+// must hash the same, a run with it writes the golden file to check the broadphase against.
+// Scripted runs draw a new seed unless given --seed, so both runs need the same one.
+//
+// --no-alloc-after fails the run when any scheduled system allocates once the given number of
+// warmup ticks has passed. It needs a build with SURVIVE_TRACK_ALLOCATIONS.
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "Game.h"
+#include "Entity.h"
+#include "Config/EntityConfigLoader.h"
+#include "Config/EntityManager.h"
+#include "InputSource.h"
+#include "JobSystem.h"
+#include "PerfCounters.h"
+#include "Profiler.h"
+#include "ResourceManager.h"
+#include "WorldHash.h"
+#include "MathUtils.h"
+
+namespace {
+    // Sums over the run for one scheduled system
+    struct SystemTotals
+    {
+        double ms{0.0};
+        PerfCounters::Sample counters;
+        AllocCounts allocations;
+    };
+
+    // Spawns the boxes up front, then walks the player around a square while sweeping the
+    // mouse in a circle and firing every second
+    ScriptedInputSource makeScenario(uint64_t ticks, int boxes)
+    {
+        ScriptedInputSource script;
+
+        for (int i = 0; i < boxes; i++) {
+            script.press(static_cast<uint64_t>(i), sf::Keyboard::B);
+        }
+
+        const sf::Keyboard::Key walk[] = {sf::Keyboard::D, sf::Keyboard::S, sf::Keyboard::A,
+                                          sf::Keyboard::W};
+        const uint64_t legTicks = 144;
+        for (uint64_t tick = 0, leg = 0; tick < ticks; tick += legTicks, leg++) {
+            script.press(tick, walk[leg % 4]);
+            script.release(tick + legTicks - 1, walk[leg % 4]);
+        }
+
+        const sf::Vector2f center(Constants::SCREEN_WIDTH / 2.f, Constants::SCREEN_HEIGHT / 2.f);
+        for (uint64_t tick = 0; tick < ticks; tick += 10) {
+            float angle = 2.f * PI * static_cast<float>(tick % 720) / 720.f;
+            script.moveMouse(tick, center + sf::Vector2f(std::cos(angle), std::sin(angle)) * 400.f);
+        }
+
+        for (uint64_t tick = 30; tick < ticks; tick += 144) {
+            script.press(tick, sf::Keyboard::Space);
+            script.release(tick + 1, sf::Keyboard::Space);
+        }
+
+        return script;
+    }
+
+    // The first tick where the run and the golden hashes part ways and the first entity that
+    // differs, its index is stable since entities are only ever appended
+    void reportDivergence(uint64_t tick, uint64_t worldHash, const WorldHashLog &golden,
+                          size_t entity, const std::vector<std::unique_ptr<Entity>> &entities)
+    {
+        std::cerr << "Tick " << tick << " diverged: world hash " << std::hex << worldHash
+                  << ", expected " << golden.getWorldHash(tick) << std::dec << "\n";
+        if (entity == WorldHashLog::WORLD_HASH_ONLY) {
+            std::cerr << "  every entity hash matches in the bits the log keeps, only the world "
+                         "hash differs\n";
+        }
+        else if (entity < entities.size() && entity < golden.getEntityCount(tick)) {
+            const Entity &first = *entities[entity];
+            const sf::Vector2f position = first.getPosition();
+            std::cerr << "  first differing entity #" << entity << " "
+                      << EntityConfigLoader::getTypeName(first.getType()) << " at ("
+                      << position.x << ", " << position.y << ")\n";
+        }
+        else {
+            std::cerr << "  entity count " << entities.size() << ", expected "
+                      << golden.getEntityCount(tick) << "\n";
+        }
+        std::cerr.flush();
+    }
+
+    // Average time per tick of every system, with its allocations and hardware counters when
+    // they were tracked
+    void printSystemReport(const SystemScheduler &scheduler,
+                           const std::vector<SystemTotals> &totals, uint64_t ticks)
+    {
+        const double perTick = ticks ? 1.0 / ticks : 0.0;
+        std::cout << "per tick: ms";
+        if (AllocTracker::isEnabled()) {
+            std::cout << " allocations bytes";
+        }
+        if (PerfCounters::getInstance().isEnabled()) {
+            for (const char *name : PerfCounters::getNames()) {
+                std::cout << " " << name;
+            }
+            std::cout << " ipc";
+        }
+        std::cout << "\n";
+
+        for (size_t i = 0; i < scheduler.getSystemCount(); i++) {
+            std::cout << "  " << scheduler.getSystemName(i) << " " << totals[i].ms * perTick;
+            if (AllocTracker::isEnabled()) {
+                std::cout << " " << totals[i].allocations.count * perTick << " "
+                          << totals[i].allocations.bytes * perTick;
+            }
+            const PerfCounters::Sample &counters = totals[i].counters;
+            if (counters.valid) {
+                for (size_t counter = 0; counter < PerfCounters::COUNT; counter++) {
+                    const double value = counters.values[counter] * perTick;
+                    if (counters.has(static_cast<PerfCounters::Counter>(counter)))
+                        std::cout << " " << static_cast<uint64_t>(value);
+                    else
+                        std::cout << " -";
+                }
+                std::cout << " " << counters.getIpc();
+            }
+            std::cout << "\n";
+        }
+        std::cout.flush();
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    ResourceManager::init(argv[0]);
+    PROFILE_THREAD_NAME("main");
+
+    uint64_t ticks = 144 * 60;
+    float deltaTime = 1.f / 144.f;
+    int boxes = 200;
+    int wave = 0;
+    const char *tracePath = nullptr;
+    const char *replayPath = nullptr;
+    const char *hashOutPath = nullptr;
+    const char *hashCheckPath = nullptr;
+    bool hasSeed = false;
+    uint32_t seed = 0;
+    int64_t noAllocAfter = -1;
+    bool collisionSweep = false;
+    int64_t reloadAt = -1;
+    for (int i = 1; i < argc; i += 2) {
+        // The flags without a value
+        if (std::strcmp(argv[i], "--counters") == 0) {
+            PerfCounters::getInstance().setEnabled(true);
+            i--;
+            continue;
+        }
+        if (std::strcmp(argv[i], "--collision-sweep") == 0) {
+            collisionSweep = true;
+            i--;
+            continue;
+        }
+        if (i + 1 == argc) {
+            std::cerr << "Missing value for " << argv[i] << std::endl;
+            return 1;
+        }
+        if (std::strcmp(argv[i], "--ticks") == 0)
+            ticks = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--dt") == 0)
+            deltaTime = std::strtof(argv[i + 1], nullptr);
+        else if (std::strcmp(argv[i], "--boxes") == 0)
+            boxes = std::atoi(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--wave") == 0)
+            wave = std::atoi(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--seed") == 0) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+            hasSeed = true;
+        }
+        else if (std::strcmp(argv[i], "--replay") == 0)
+            replayPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--hash-out") == 0)
+            hashOutPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--hash-check") == 0)
+            hashCheckPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--trace") == 0)
+            tracePath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--no-alloc-after") == 0)
+            noAllocAfter = std::atoll(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--config") == 0)
+            EntityManager::getInstance().setConfigPath(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--reload-at") == 0)
+            reloadAt = std::atoll(argv[i + 1]);
+        else {
+            std::cerr << "Unknown argument " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (noAllocAfter >= 0 && !AllocTracker::isEnabled()) {
+        std::cerr << "--no-alloc-after needs a build with SURVIVE_TRACK_ALLOCATIONS on"
+                  << std::endl;
+        return 1;
+    }
+
+    // The wave would add entities the recorded session never had
+    if (replayPath && wave > 0) {
+        std::cerr << "--replay cannot be combined with --wave" << std::endl;
+        return 1;
+    }
+
+    InputRecording recording;
+    if (replayPath) {
+        if (!recording.read(replayPath)) {
+            return 1;
+        }
+        ticks = recording.getFrameCount();
+        seed = recording.getSeed();
+        hasSeed = true;
+    }
+
+    WorldHashLog golden;
+    if (hashCheckPath && !golden.read(hashCheckPath)) {
+        return 1;
+    }
+
+    std::unique_ptr<Game> pGame = std::make_unique<Game>();
+    if (!pGame->initialise(true)) {
+        std::cerr << "Game Failed to initialise" << std::endl;
+        return 1;
+    }
+    if (hasSeed) {
+        pGame->setSeed(seed);
+    }
+    pGame->getCollisionSystem().setBroadphaseEnabled(!collisionSweep);
+
+    // A vampire wave up front, spread over the screen on a grid so the run is repeatable
+    if (wave > 0) {
+        std::vector<sf::Vector2f> positions;
+        positions.reserve(wave);
+        const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(wave))));
+        const sf::Vector2f cell(static_cast<float>(Constants::SCREEN_WIDTH) / columns,
+                                static_cast<float>(Constants::SCREEN_HEIGHT) / columns);
+        for (int i = 0; i < wave; i++) {
+            positions.emplace_back((i % columns + 0.5f) * cell.x, (i / columns + 0.5f) * cell.y);
+        }
+        std::vector<float> health(positions.size(), Constants::VAMPIRE_HEALTH);
+        pGame->spawnWave(EntityType::VAMPIRE, positions, {}, health);
+    }
+
+    // A replay brings its own input, the scripted player only runs without one
+    ScriptedInputSource script = replayPath ? ScriptedInputSource() : makeScenario(ticks, boxes);
+    ReplayInputSource replay(recording);
+    InputSource &input = replayPath ? static_cast<InputSource &>(replay) : script;
+
+    std::cout << "systems on " << JobSystem::getInstance().getThreadCount() << " threads:\n";
+    pGame->getScheduler().printGraph(std::cout);
+
+    SystemScheduler &scheduler = pGame->getScheduler();
+    std::vector<SystemTotals> totals(scheduler.getSystemCount());
+    uint64_t allocatingTicks = 0;
+    WorldHashLog hashes;
+    std::vector<uint64_t> entityHashes;
+    std::chrono::duration<double, std::milli> hashTime{0};
+    bool diverged = false;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t tick = 0; tick < ticks && !diverged; tick++) {
+        if (static_cast<int64_t>(tick) == reloadAt) {
+            pGame->reloadConfig();
+        }
+        pGame->update(replayPath ? replay.getDeltaTime() : deltaTime, input);
+
+        if (hashOutPath || hashCheckPath) {
+            auto hashStart = std::chrono::steady_clock::now();
+            const uint64_t worldHash = WorldHash::hashWorld(pGame->getEntities(), entityHashes);
+            if (hashOutPath) {
+                hashes.add(worldHash, entityHashes);
+            }
+            if (hashCheckPath && tick < golden.getTickCount()) {
+                const size_t entity = golden.findDivergence(tick, worldHash, entityHashes);
+                if (entity != WorldHashLog::NO_DIVERGENCE) {
+                    reportDivergence(tick, worldHash, golden, entity, pGame->getEntities());
+                    // Stop here, the report below covers the ticks that ran
+                    diverged = true;
+                    ticks = tick + 1;
+                }
+            }
+            hashTime += std::chrono::steady_clock::now() - hashStart;
+        }
+
+        bool allocated = false;
+        for (size_t i = 0; i < scheduler.getSystemCount(); i++) {
+            totals[i].ms += scheduler.getLastDurationMs(i);
+            totals[i].counters += scheduler.getLastCounters(i);
+            totals[i].allocations += scheduler.getLastAllocations(i);
+            allocated |= scheduler.getLastAllocations(i).count > 0;
+        }
+
+        // Name the offenders of the first steady state tick that allocates, count the rest
+        if (allocated && noAllocAfter >= 0 && tick >= static_cast<uint64_t>(noAllocAfter)) {
+            if (allocatingTicks++ == 0) {
+                std::cerr << "Tick " << tick << " allocated in:";
+                for (size_t i = 0; i < scheduler.getSystemCount(); i++) {
+                    const AllocCounts &allocations = scheduler.getLastAllocations(i);
+                    if (allocations.count > 0) {
+                        std::cerr << " " << scheduler.getSystemName(i) << " ("
+                                  << allocations.count << " allocations, " << allocations.bytes
+                                  << " bytes)";
+                    }
+                }
+                std::cerr << std::endl;
+            }
+        }
+    }
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start - hashTime;
+
+    std::cout << "ticks: " << ticks << "\n"
+              << "seed: " << pGame->getSeed() << "\n"
+              << "entities: " << pGame->getEntityCount() << "\n"
+              << "total ms: " << elapsed.count() << "\n"
+              << "ms per tick: " << (ticks ? elapsed.count() / ticks : 0.0) << "\n";
+
+    const AnimationSystem &animation = pGame->getAnimationSystem();
+    uint64_t rectUpdates = animation.getTotalRectUpdateCount();
+    uint64_t skipped = animation.getTotalSkippedUpdateCount();
+    std::cout << "animation rect updates: " << rectUpdates << ", skipped: " << skipped << " ("
+              << (rectUpdates + skipped ? 100.0 * skipped / (rectUpdates + skipped) : 0.0)
+              << "%)" << std::endl;
+
+    printSystemReport(scheduler, totals, ticks);
+
+    const uint64_t worldHash = WorldHash::hashWorld(pGame->getEntities(), entityHashes);
+    std::cout << "world hash: " << std::hex << worldHash << std::dec << std::endl;
+    if (hashCheckPath && !diverged) {
+        if (golden.getTickCount() != ticks) {
+            std::cerr << "Hash check: " << hashCheckPath << " has " << golden.getTickCount()
+                      << " ticks, the run had " << ticks << std::endl;
+            diverged = true;
+        }
+        else {
+            std::cout << "hash check: all " << ticks << " ticks match" << std::endl;
+        }
+    }
+    if (hashOutPath && !hashes.write(hashOutPath)) {
+        return 1;
+    }
+
+    if (tracePath) {
+#ifdef SURVIVE_PROFILING
+        if (!Profiler::getInstance().writeChromeTrace(tracePath)) {
+            return 1;
+        }
+#else
+        std::cerr << "--trace needs a build with SURVIVE_PROFILING on" << std::endl;
+#endif
+    }
+
+    if (diverged) {
+        return 1;
+    }
+    if (allocatingTicks > 0) {
+        std::cerr << "FAILED: " << allocatingTicks << " ticks after the first " << noAllocAfter
+                  << " allocated in scheduled systems" << std::endl;
+        return 1;
+    }
+    return 0;
+}